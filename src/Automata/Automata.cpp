@@ -34,7 +34,7 @@ namespace OuroborosModules::Modules::Automata {
         // Configure parameters and I/O.
         configButton (PARAM_STEP_BUTTON, "Step sequence");
         configButton (PARAM_RESET_BUTTON, "Reset");
-        configInput (INPUT_CLOCK, "Clock");
+        configInput (INPUT_CLOCK, "Clock")->description = "Every channel plays its own board, starting from the same seed.";
         configInput (INPUT_RESET, "Reset trigger");
 
         configButton (PARAM_RANDOMIZE_BUTTON, "Randomize");
@@ -49,6 +49,9 @@ namespace OuroborosModules::Modules::Automata {
         configInput (INPUT_LENGTH_CV, "Automatic reset length CV");
         configParam (PARAM_LENGTH_CV_ATTENUVERTER, -1.f, 1.f, 0.f, "Automatic reset length CV attenuverter", "%", 0, 100);
 
+        configInput (INPUT_REVERSE, "Reverse step trigger");
+        configInput (INPUT_SCRUB, "Rewind scrub CV")->description = "0V is the newest generation, 10V the oldest one remembered.";
+
         auto modeSelectLabels = std::vector<std::string> ();
         modeSelectLabels.reserve (TriggerCount + 2);
         modeSelectLabels.push_back ("Play");
@@ -60,29 +63,38 @@ namespace OuroborosModules::Modules::Automata {
         for (int i = 0; i < TriggerCount; i++)
             configOutput (OUTPUT_TRIGGER + i, fmt::format (FMT_STRING ("Trigger set {}"), i + 1));
         configOutput (OUTPUT_EOC, "End of Cycle");
+        configOutput (OUTPUT_CYCLE_LENGTH, "Board cycle length");
+        configOutput (OUTPUT_STAGNATION, "Board stagnation");
+        for (int i = 0; i < DensityOutputCount; i++) {
+            auto firstChannel = i * Constants::MaxPolyphony + 1;
+            auto lastChannel = (i + 1) * Constants::MaxPolyphony;
+            configOutput (OUTPUT_ROW_DENSITY + i, fmt::format (FMT_STRING ("Rows {}-{} density"), firstChannel, lastChannel))->description =
+                "Share of live cells per row, one channel per row. Boards taller than 32 rows group neighbouring rows.";
+            configOutput (OUTPUT_COLUMN_DENSITY + i, fmt::format (FMT_STRING ("Columns {}-{} density"), firstChannel, lastChannel))->description =
+                "Share of live cells per column, one channel per column. Boards wider than 32 columns group neighbouring columns.";
+        }
 
         // Disable randomization for relevant params.
         getParamQuantity (PARAM_MODE_SELECT)->randomizeEnabled = false;
 
         initialize ();
+        setRandomSeed (rack::random::u64 ());
 
         // Clock dividers.
         clockLights = DSP::ClockDivider (32, rack::random::u32 ());
         clockParams = DSP::ClockDivider (32, rack::random::u32 ());
+        clockDisplay = DSP::ClockDivider (512, rack::random::u32 ());
 
         // Schmitt triggers
         stepButtonTrigger = rack::dsp::SchmittTrigger ();
-        clockTrigger = rack::dsp::SchmittTrigger ();
-
         resetButtonTrigger = rack::dsp::SchmittTrigger ();
-        resetTrigger = rack::dsp::SchmittTrigger ();
-
         randomizeButtonTrigger = rack::dsp::SchmittTrigger ();
-        randomizeTrigger = rack::dsp::SchmittTrigger ();
 
         lengthButtonTrigger = rack::dsp::SchmittTrigger ();
         lengthEnableTrigger = rack::dsp::SchmittTrigger ();
 
+        reverseTrigger = rack::dsp::SchmittTrigger ();
+
         // Widget communication
         updateRulesSignal.store (false);
     }
@@ -93,12 +105,26 @@ namespace OuroborosModules::Modules::Automata {
         // Initialize state.
         currentMode = AutomataMode::Play;
         lengthEnabled = false;
-        stepCount = 0;
+        // Extra channels get reset to the board when they start playing.
+        channelCount = 1;
+        for (auto& channel : channels)
+            channel = AutomataChannel ();
+        audioRateCounter = 0;
+        triggerLocationsDirty = true;
+        // Never a board version, so the densities get counted on the next sample.
+        densityVersion = std::numeric_limits<uint64_t>::max ();
+        lastScrubStep = -1;
 
         // Initialize options.
         randomizeOnManualReset = false;
         randomizeOnAutoReset = false;
         momentaryLengthEnable = false;
+        reseedOnReset = false;
+        resetOnCycle = false;
+        audioRateDivision = 0;
+        rewindLength = DefaultRewindLength;
+
+        displayDataPending = true;
     }
 
     void AutomataModule::process (const ProcessArgs& args) {
@@ -108,44 +134,54 @@ namespace OuroborosModules::Modules::Automata {
         auto lightTime = args.sampleTime * clockLights.division;
         auto lightsClocked = clockLights.process ();
         auto paramsClocked = clockParams.process ();
+        auto displayClocked = clockDisplay.process ();
+
+        if (reseedSignal.exchange (false))
+            rng.seed (randomSeed.load ());
 
         while (!commandQueue.empty ()) {
-            auto [isUndo, cmd] = commandQueue.consume ();
+            auto [isUndo, cmd] = commandQueue.front ();
             if (!isUndo)
                 cmd->execute (lifeBoard.getBoard ());
             else
                 cmd->undo (lifeBoard.getBoard ());
+            commandQueue.pop ();
 
-            cmd->executed = true;
             lifeBoard.markUpdated ();
+            triggerLocationsDirty = true;
         }
 
+        if (triggerLocationsDirty)
+            countTriggerLocations ();
+
         auto newRules = this->newRules;
-        if (updateRulesSignal.exchange (false))
+        if (updateRulesSignal.exchange (false)) {
             lifeBoard.setRules (newRules);
+            displayDataPending = true;
+        }
 
         // Handle params.
-        if (paramsClocked)
-            currentMode = modeFromSelectorParam (params [PARAM_MODE_SELECT].getValue ());
-
-        // Handle reset.
-        auto resetPulseHigh = resetPulse.process (args.sampleTime);
-        if (resetButtonTrigger.process (params [PARAM_RESET_BUTTON].getValue ()) |
-            resetTrigger.process (inputs [INPUT_RESET].getVoltage (), TriggerThreshLow, TriggerThreshHigh)) {
-            processReset (false);
-
-            lights [LIGHT_RESET_BUTTON].setBrightness (1);
-        } else if (lightsClocked)
-            lights [LIGHT_RESET_BUTTON].setBrightnessSmooth (0.f, lightTime);
+        if (paramsClocked) {
+            auto newMode = modeFromSelectorParam (params [PARAM_MODE_SELECT].getValue ());
+            displayDataPending |= newMode != currentMode;
+            currentMode = newMode;
+        }
 
-        // Handle randomize.
-        if (randomizeButtonTrigger.process (params [PARAM_RANDOMIZE_BUTTON].getValue ()) |
-            randomizeTrigger.process (inputs [INPUT_RANDOMIZE].getVoltage (), TriggerThreshLow, TriggerThreshHigh)) {
-            processRandomize ();
+        // Every channel of the clock input plays its own board.
+        const auto& board = lifeBoard.getBoard ();
+        auto newChannelCount = std::clamp (inputs [INPUT_CLOCK].getChannels (), 1, Constants::MaxPolyphony);
+        for (int c = 1; c < newChannelCount; c++) {
+            if (c >= channelCount || !getVoice (c).matchesBoard (board)) {
+                getVoice (c).reset (board);
+                channels [c] = AutomataChannel ();
+            }
+        }
+        channelCount = newChannelCount;
 
-            lights [LIGHT_RANDOMIZE_BUTTON].setBrightness (1);
-        } else if (lightsClocked)
-            lights [LIGHT_RANDOMIZE_BUTTON].setBrightnessSmooth (0.f, lightTime);
+        // The buttons affect every channel.
+        auto resetPressed = resetButtonTrigger.process (params [PARAM_RESET_BUTTON].getValue ());
+        auto randomizePressed = randomizeButtonTrigger.process (params [PARAM_RANDOMIZE_BUTTON].getValue ());
+        auto stepPressed = stepButtonTrigger.process (params [PARAM_STEP_BUTTON].getValue ());
 
         // Handle length toggle.
         auto lengthButtonPressed = lengthButtonTrigger.process (params [PARAM_LENGTH_BUTTON].getValue ());
@@ -154,152 +190,310 @@ namespace OuroborosModules::Modules::Automata {
             lengthEnabled = inputs [INPUT_LENGTH_ENABLE].getVoltage () >= TriggerThreshHigh;
         else if (lengthButtonPressed || lengthEnableRise)
             lengthEnabled = !lengthEnabled;
-        stepCount = lengthEnabled ? stepCount : 0;
 
         if (lightsClocked)
             lights [LIGHT_LENGTH_BUTTON].setBrightnessSmooth (boolToLight (lengthEnabled), lightTime);
 
-        // Handle step/clock.
-        auto doStep = stepButtonTrigger.process (params [PARAM_STEP_BUTTON].getValue ())
-                    | clockTrigger.process (inputs [INPUT_CLOCK].getVoltage (), TriggerThreshLow, TriggerThreshHigh);
+        // In audio-rate mode, every channel steps on the internal clock instead of the clock input.
+        auto audioRateStep = false;
+        if (audioRateDivision > 0 && ++audioRateCounter >= audioRateDivision) {
+            audioRateCounter = 0;
+            audioRateStep = true;
+        }
+
+        processRewind ();
+
+        rngReseeded = false;
+        auto didReset = false;
+        auto didRandomize = false;
         auto didStep = false;
-        auto eocReset = false;
-        if (doStep && !resetPulseHigh) {
-            if (lengthEnabled) {
-                auto seqLength = params [PARAM_LENGTH].getValue ();
-                seqLength += inputs [INPUT_LENGTH_CV].getVoltage () / 10.f
-                           * params [PARAM_LENGTH_CV_ATTENUVERTER].getValue ()
-                           * MaxSequenceLength;
-                seqLength = std::clamp (seqLength, 1.f, static_cast<float> (MaxSequenceLength));
-                eocReset = ++stepCount >= static_cast<int> (seqLength);
+        for (int c = 0; c < channelCount; c++) {
+            auto& channel = channels [c];
+            channel.stepCount = lengthEnabled ? channel.stepCount : 0;
+
+            // Handle reset.
+            auto resetPulseHigh = channel.resetPulse.process (args.sampleTime);
+            if (resetPressed | channel.resetTrigger.process (inputs [INPUT_RESET].getPolyVoltage (c), TriggerThreshLow, TriggerThreshHigh)) {
+                processReset (c, false);
+                didReset = true;
             }
 
-            processStep (args);
-            didStep = true;
+            // Handle randomize.
+            if (randomizePressed | channel.randomizeTrigger.process (inputs [INPUT_RANDOMIZE].getPolyVoltage (c), TriggerThreshLow, TriggerThreshHigh)) {
+                processRandomize (c);
+                didRandomize = true;
+            }
 
-            lights [LIGHT_STEP_BUTTON].setBrightness (1);
-        } else if (lightsClocked)
-            lights [LIGHT_STEP_BUTTON].setBrightnessSmooth (0.f, lightTime);
+            // Handle step/clock.
+            auto clockRise = channel.clockTrigger.process (inputs [INPUT_CLOCK].getVoltage (c), TriggerThreshLow, TriggerThreshHigh);
+            auto doStep = stepPressed | (audioRateDivision > 0 ? audioRateStep : clockRise);
+            auto eocReset = false;
+            if (doStep && !resetPulseHigh) {
+                if (lengthEnabled) {
+                    auto seqLength = params [PARAM_LENGTH].getValue ();
+                    seqLength += inputs [INPUT_LENGTH_CV].getPolyVoltage (c) / 10.f
+                               * params [PARAM_LENGTH_CV_ATTENUVERTER].getValue ()
+                               * MaxSequenceLength;
+                    seqLength = std::clamp (seqLength, 1.f, static_cast<float> (MaxSequenceLength));
+                    eocReset = ++channel.stepCount >= static_cast<int> (seqLength);
+                }
 
-        // Process outputs.
-        if (didStep)
-            processTriggers ();
+                processStep (args, c);
+                processTriggers (c);
+                didStep = true;
+
+                channel.cycleLength = c == 0 ? lifeBoard.getCycleLength () : getVoice (c).getCycleLength ();
+                eocReset |= resetOnCycle && channel.cycleLength > 0;
+            }
 
-        if (eocReset)
-            processReset (true);
+            if (eocReset)
+                processReset (c, true);
 
-        for (int i = 0; i < TriggerCount; i++) {
-            float pulseHigh = outputPulses [i].process (args.sampleTime);
+            // Process outputs.
+            for (int i = 0; i < TriggerCount; i++) {
+                float pulseHigh = channel.outputPulses [i].process (args.sampleTime);
+
+                float outputValue;
+                switch (triggerInfo [i].outputMode) {
+                    default:
+                    case AutomataTriggerOutputMode::Trigger: outputValue = boolToGate (pulseHigh); break;
+                    case AutomataTriggerOutputMode::Percentage: outputValue = channel.outputValues [i]; break;
+                }
 
-            float outputValue;
-            switch (triggerInfo [i].outputMode) {
-                default:
-                case AutomataTriggerOutputMode::Trigger: outputValue = boolToGate (pulseHigh); break;
-                case AutomataTriggerOutputMode::Percentage: outputValue = outputValues [i]; break;
+                outputs [OUTPUT_TRIGGER + i].setVoltage (outputValue, c);
             }
 
-            outputs [OUTPUT_TRIGGER + i].setVoltage (outputValue);
+            outputs [OUTPUT_EOC].setVoltage (boolToGate (channel.eocPulse.process (args.sampleTime)), c);
+            outputs [OUTPUT_CYCLE_LENGTH].setVoltage (channel.cycleLength * CycleLengthVoltage, c);
+            outputs [OUTPUT_STAGNATION].setVoltage (boolToGate (channel.cycleLength > 0), c);
         }
 
-        outputs [OUTPUT_EOC].setVoltage (boolToGate (eocPulse.process (args.sampleTime)));
+        for (int i = 0; i < TriggerCount; i++)
+            outputs [OUTPUT_TRIGGER + i].setChannels (channelCount);
+        outputs [OUTPUT_EOC].setChannels (channelCount);
+        outputs [OUTPUT_CYCLE_LENGTH].setChannels (channelCount);
+        outputs [OUTPUT_STAGNATION].setChannels (channelCount);
+
+        if (didReset)
+            lights [LIGHT_RESET_BUTTON].setBrightness (1);
+        else if (lightsClocked)
+            lights [LIGHT_RESET_BUTTON].setBrightnessSmooth (0.f, lightTime);
 
-        lifeBoard.handleUpdated ();
+        if (didRandomize)
+            lights [LIGHT_RANDOMIZE_BUTTON].setBrightness (1);
+        else if (lightsClocked)
+            lights [LIGHT_RANDOMIZE_BUTTON].setBrightnessSmooth (0.f, lightTime);
+
+        if (didStep)
+            lights [LIGHT_STEP_BUTTON].setBrightness (1);
+        else if (lightsClocked)
+            lights [LIGHT_STEP_BUTTON].setBrightnessSmooth (0.f, lightTime);
+
+        // The densities follow the main board, so they only need counting again when it changes.
+        if (lifeBoard.getVersion () != densityVersion)
+            processDensities ();
+
+        // Start calculating the next generation in the background, so the next clock edge only has to pick it up.
+        // Not needed when the board replays its cycle or rewind history, and not possible when decaying cells matter.
+        // Not done at audio rate either, where every sample would ask for a new one, or for boards quicker to step here.
+        auto boardVersion = lifeBoard.getVersion ();
+        if (audioRateDivision == 0 && lifeBoard.canStepAhead () && !stepJob.hasJob (boardVersion) && stepJob.isAvailable () &&
+            AutomataStepJob::isWorthRequesting (lifeBoard))
+            stepJob.request (lifeBoard);
+
+        // Publish the display data at about the screen's rate, and only when something changed.
+        displayDataPending |= lifeBoard.handleUpdated ();
+        if (displayDataPending && displayClocked) {
+            auto& displayData = displayTelemetry.getWriteBuffer ();
+            displayData.board = lifeBoard.getBoard ();
+            displayData.rules = lifeBoard.getRules ();
+            displayData.mode = currentMode;
+            displayData.commandsExecuted = commandQueue.getExecutedCount ();
+            displayTelemetry.publish ();
+
+            displayDataPending = false;
+        }
     }
 
-    void AutomataModule::processReset (bool automatic) {
+    void AutomataModule::processReset (int channel, bool automatic) {
+        if (reseedOnReset && !rngReseeded) {
+            rng.seed (randomSeed.load ());
+            rngReseeded = true;
+        }
+
         if ((automatic && randomizeOnAutoReset) || (!automatic && randomizeOnManualReset)) {
-            processRandomize ();
-        } else
+            processRandomize (channel);
+        } else if (channel == 0)
             lifeBoard.reset ();
+        else
+            getVoice (channel).reset (lifeBoard.getBoard ());
 
-        stepCount = 0;
-        resetPulse.trigger ();
+        channels [channel].stepCount = 0;
+        channels [channel].resetPulse.trigger ();
         if (automatic)
-            eocPulse.trigger ();
+            channels [channel].eocPulse.trigger ();
     }
 
-    void AutomataModule::processRandomize () {
+    void AutomataModule::processRandomize (int channel) {
         auto density = params [PARAM_RANDOM_DENSITY].getValue ();
-        density += inputs [INPUT_RANDOM_DENSITY_CV].getVoltage () / 10.f
+        density += inputs [INPUT_RANDOM_DENSITY_CV].getPolyVoltage (channel) / 10.f
                  * params [PARAM_RANDOM_DENSITY_CV_ATTENUVERTER].getValue ();
         density = std::clamp (density, 0.f, 1.f);
 
-        lifeBoard.randomize (density);
+        if (channel == 0)
+            lifeBoard.randomize (density, rng);
+        else
+            getVoice (channel).randomize (lifeBoard.getBoard (), density, rng);
     }
 
-    void AutomataModule::processStep (const ProcessArgs& args) {
-        lifeBoard.process ();
+    void AutomataModule::processStep (const ProcessArgs& args, int channel) {
+        // The extra channels' boards are small enough to just be stepped here.
+        if (channel > 0)
+            return getVoice (channel).process (lifeBoard.getRules ());
+
+        // Inside a cycle or when rewound the board replays its history. Otherwise, fall back to stepping here if
+        // the worker isn't done yet, or the board changed since it started.
+        auto useWorker = audioRateDivision == 0 && lifeBoard.canStepAhead ();
+        auto nextGeneration = useWorker ? stepJob.getResult (lifeBoard.getVersion ()) : nullptr;
+        if (nextGeneration != nullptr)
+            lifeBoard.process (*nextGeneration);
+        else
+            lifeBoard.process ();
     }
 
-    void AutomataModule::processTriggers () {
-        using rack::simd::float_4;
+    void AutomataModule::processRewind () {
+        using Constants::TriggerThreshLow;
+        using Constants::TriggerThreshHigh;
 
-        static constexpr int SIMDBankSize = 4;
-        static constexpr int SIMDBankCount = static_cast<int> (static_cast<float> (TriggerCount) / SIMDBankSize + .5f);
+        if (lifeBoard.getRewindLength () != rewindLength)
+            lifeBoard.setRewindLength (rewindLength);
+
+        // Only the main board remembers its generations.
+        auto rewindAge = -1;
+        if (reverseTrigger.process (inputs [INPUT_REVERSE].getVoltage (), TriggerThreshLow, TriggerThreshHigh))
+            rewindAge = lifeBoard.getRewindPosition () + 1;
+
+        // The scrub CV only moves the board when the voltage itself moves, so stepping still works while it holds still,
+        // even as the buffer fills up. It spans the generations actually remembered, so the whole range is usable before then.
+        if (inputs [INPUT_SCRUB].isConnected ()) {
+            auto scrubPosition = std::clamp (inputs [INPUT_SCRUB].getVoltage () / 10.f, 0.f, 1.f);
+            auto scrubStep = static_cast<int> (std::round (scrubPosition * MaxRewindLength));
+            if (scrubStep != lastScrubStep) {
+                lastScrubStep = scrubStep;
+                rewindAge = static_cast<int> (std::round (scrubPosition * std::max (lifeBoard.getRewindCount () - 1, 0)));
+            }
+        } else
+            lastScrubStep = -1;
 
-        float_4 triggerLocationsCount [SIMDBankCount];
-        float_4 triggerCounts [SIMDBankCount];
-        float_4 triggerNewbornMask [SIMDBankCount];
-        float_4 triggerAliveMask [SIMDBankCount];
+        if (rewindAge < 0)
+            return;
 
-        for (int i = 0, bankIdx = 0; bankIdx < SIMDBankCount; i += SIMDBankSize, bankIdx++) {
-            auto maxBankIdx = std::min (i + SIMDBankSize, TriggerCount);
+        auto oldPosition = lifeBoard.getRewindPosition ();
+        lifeBoard.rewind (rewindAge);
+        if (lifeBoard.getRewindPosition () != oldPosition) {
+            processTriggers (0);
+            channels [0].cycleLength = lifeBoard.getCycleLength ();
+        }
+    }
 
-            triggerLocationsCount [bankIdx] = float_4::zero ();
-            triggerCounts [bankIdx] = float_4::zero ();
+    void AutomataModule::processTriggers (int channel) {
+        // Every trigger set is its own plane, so counting is a popcount of the masked live words.
+        const auto& board = lifeBoard.getBoard ();
+        auto liveWords = getChannelLivePlane (channel).data ();
+        auto prevLiveWords = getChannelLivePlanePrev (channel).data ();
+        auto wordCount = board.getLivePlane ().getWordCount ();
+        auto& channelState = channels [channel];
 
-            int newbornMaskMoveMask = 0;
-            int aliveMaskMoveMask = 0;
-            for (int j = i; j < maxBankIdx; j++) {
-                const auto& curTriggerInfo = triggerInfo [j];
-                int laneMask = 1 << (j - i);
+        for (int i = 0; i < TriggerCount; i++) {
+            auto triggerWords = board.getPlane (cellFromTriggerIndex (i)).data ();
+            auto countNewborn = triggerInfo [i].countMode == AutomataTriggerCountMode::Newborn;
 
-                newbornMaskMoveMask |= curTriggerInfo.countMode == AutomataTriggerCountMode::Newborn ? laneMask : 0;
-                aliveMaskMoveMask |= curTriggerInfo.countMode == AutomataTriggerCountMode::IsAlive ? laneMask : 0;
+            int hitsCount = 0;
+            for (int wordI = 0; wordI < wordCount; wordI++) {
+                auto countedCells = liveWords [wordI] & (countNewborn ? ~prevLiveWords [wordI] : ~BoardRow (0));
+                hitsCount += __builtin_popcount (countedCells & triggerWords [wordI]);
             }
 
-            triggerNewbornMask [bankIdx] = rack::simd::movemaskInverse<float_4> (newbornMaskMoveMask);
-            triggerAliveMask [bankIdx] = rack::simd::movemaskInverse<float_4> (aliveMaskMoveMask);
+            if (hitsCount > 0)
+                channelState.outputPulses [i].trigger ();
+            channelState.outputValues [i] = static_cast<float> (hitsCount) / std::max (triggerLocations [i], 1) * 10.f;
         }
+    }
 
-        const auto& board = lifeBoard.getBoard ();
-        auto liveFlag = board.getLiveFlag ();
-        auto prevLiveFlag = board.getLiveFlagPrev ();
-
-        for (int y = 0; y < BoardHeight; y++) {
-            for (int x = 0; x < BoardWidth; x++) {
-                const auto& cell = board.at (x, y);
+    void AutomataModule::processDensities () {
+        using Constants::MaxPolyphony;
+        static constexpr int MaxDensityChannels = DensityOutputCount * MaxPolyphony;
+
+        const auto& livePlane = lifeBoard.getBoard ().getLivePlane ();
+        auto rowWords = livePlane.getRowWords ();
+        auto width = livePlane.getWidth ();
+        auto height = livePlane.getHeight ();
+
+        // Every row and column gets its own channel, continuing on the next output after 16. Boards with more of them
+        // than the outputs have channels group neighbouring ones into bands.
+        // A band's rows are consecutive words, so it's a popcount of all of them.
+        auto rowBands = std::min (height, MaxDensityChannels);
+        for (int band = 0; band < rowBands; band++) {
+            auto rowStart = band * height / rowBands;
+            auto rowCount = (band + 1) * height / rowBands - rowStart;
+            auto bandWords = livePlane.getRow (rowStart);
+
+            int liveCount = 0;
+            for (int wordI = 0; wordI < rowCount * rowWords; wordI++)
+                liveCount += __builtin_popcount (bandWords [wordI]);
+
+            auto density = static_cast<float> (liveCount) / (rowCount * width) * 10.f;
+            outputs [OUTPUT_ROW_DENSITY + band / MaxPolyphony].setVoltage (density, band % MaxPolyphony);
+        }
 
-                auto isAlive = testCellFlag (cell, liveFlag);
-                auto newborn = !testCellFlag (cell, prevLiveFlag) & isAlive;
-                auto triggers = extractCellTriggers (cell);
+        // A band of columns is a popcount of the same bits of every row, masked out of the words it covers.
+        auto columnBands = std::min (width, MaxDensityChannels);
+        for (int band = 0; band < columnBands; band++) {
+            auto columnStart = band * width / columnBands;
+            auto columnEnd = (band + 1) * width / columnBands;
 
-                for (int bankIdx = 0; bankIdx < SIMDBankCount; bankIdx++) {
-                    auto triggersMask = rack::simd::movemaskInverse<float_4> (triggers >> (bankIdx * SIMDBankSize));
-                    triggerCounts [bankIdx] += (triggerAliveMask [bankIdx] & triggersMask & float_4 (isAlive ? 1 : 0))
-                                            +  (triggerNewbornMask [bankIdx] & triggersMask & float_4 (newborn ? 1 : 0));
+            int liveCount = 0;
+            for (int wordI = columnStart / BoardWordBits; wordI * BoardWordBits < columnEnd; wordI++) {
+                auto firstBit = std::max (columnStart - wordI * BoardWordBits, 0);
+                auto endBit = std::min (columnEnd - wordI * BoardWordBits, BoardWordBits);
+                auto mask = (~BoardRow (0) >> (BoardWordBits - (endBit - firstBit))) << firstBit;
 
-                    triggerLocationsCount [bankIdx] += triggersMask & float_4 (1);
-                }
+                for (int y = 0; y < height; y++)
+                    liveCount += __builtin_popcount (livePlane.getRow (y) [wordI] & mask);
             }
+
+            auto density = static_cast<float> (liveCount) / ((columnEnd - columnStart) * height) * 10.f;
+            outputs [OUTPUT_COLUMN_DENSITY + band / MaxPolyphony].setVoltage (density, band % MaxPolyphony);
         }
 
-        for (int bankIdx = 0, i = 0; bankIdx < SIMDBankCount; bankIdx++, i += SIMDBankSize) {
-            auto maxBankIdx = std::min (i + SIMDBankSize, TriggerCount);
+        // Outputs past the last row or column are left with a single silent channel.
+        for (int i = 0; i < DensityOutputCount; i++) {
+            auto rowChannels = rowBands - i * MaxPolyphony;
+            if (rowChannels < 1)
+                outputs [OUTPUT_ROW_DENSITY + i].setVoltage (0.f);
+            outputs [OUTPUT_ROW_DENSITY + i].setChannels (std::clamp (rowChannels, 1, MaxPolyphony));
+
+            auto columnChannels = columnBands - i * MaxPolyphony;
+            if (columnChannels < 1)
+                outputs [OUTPUT_COLUMN_DENSITY + i].setVoltage (0.f);
+            outputs [OUTPUT_COLUMN_DENSITY + i].setChannels (std::clamp (columnChannels, 1, MaxPolyphony));
+        }
 
-            float percentageBank [SIMDBankSize];
-            float hitsCountBank [SIMDBankSize];
+        densityVersion = lifeBoard.getVersion ();
+    }
 
-            (triggerCounts [bankIdx] / rack::simd::fmax (triggerLocationsCount [bankIdx], float_4 (1))).store (percentageBank);
-            triggerCounts [bankIdx].store (hitsCountBank);
+    void AutomataModule::countTriggerLocations () {
+        const auto& board = lifeBoard.getBoard ();
+        for (int i = 0; i < TriggerCount; i++) {
+            const auto& triggerPlane = board.getPlane (cellFromTriggerIndex (i));
+            auto triggerWords = triggerPlane.data ();
 
-            for (int j = i; j < maxBankIdx; j++) {
-                auto laneIdx = j - i;
-                if (hitsCountBank [laneIdx] > 0)
-                    outputPulses [j].trigger ();
-                outputValues [j] = percentageBank [laneIdx] * 10.f;
-            }
+            triggerLocations [i] = 0;
+            for (int wordI = 0; wordI < triggerPlane.getWordCount (); wordI++)
+                triggerLocations [i] += __builtin_popcount (triggerWords [wordI]);
         }
+
+        triggerLocationsDirty = false;
     }
 
     void AutomataModule::onReset (const ResetEvent& e) {
@@ -316,7 +510,12 @@ namespace OuroborosModules::Modules::Automata {
         json_object_set_new_bool (rootJ, "randomizeOnManualReset", randomizeOnManualReset);
         json_object_set_new_bool (rootJ, "randomizeOnAutoReset", randomizeOnAutoReset);
         json_object_set_new_bool (rootJ, "momentaryLengthEnable", momentaryLengthEnable);
-        json_object_set_new_int (rootJ, "stepCount", stepCount);
+        json_object_set_new_int (rootJ, "stepCount", channels [0].stepCount);
+        json_object_set_new_int (rootJ, "randomSeed", static_cast<json_int_t> (randomSeed.load ()));
+        json_object_set_new_bool (rootJ, "reseedOnReset", reseedOnReset);
+        json_object_set_new_bool (rootJ, "resetOnCycle", resetOnCycle);
+        json_object_set_new_int (rootJ, "audioRateDivision", audioRateDivision);
+        json_object_set_new_int (rootJ, "rewindLength", rewindLength);
 
         auto triggerInfoJ = json_array ();
         for (int i = 0; i < TriggerCount; i++)
@@ -330,13 +529,26 @@ namespace OuroborosModules::Modules::Automata {
         ModuleBase::dataFromJson (rootJ);
 
         commandQueue.clear ();
+        displayDataPending = true;
+        channelCount = 1;
+        triggerLocationsDirty = true;
 
         json_object_try_get_struct (rootJ, "boardData", lifeBoard);
         json_object_try_get_bool (rootJ, "lengthEnabled", lengthEnabled);
         json_object_try_get_bool (rootJ, "randomizeOnManualReset", randomizeOnManualReset);
         json_object_try_get_bool (rootJ, "randomizeOnAutoReset", randomizeOnAutoReset);
         json_object_try_get_bool (rootJ, "momentaryLengthEnable", momentaryLengthEnable);
-        json_object_try_get_int (rootJ, "stepCount", stepCount);
+        json_object_try_get_int (rootJ, "stepCount", channels [0].stepCount);
+        json_object_try_get_bool (rootJ, "reseedOnReset", reseedOnReset);
+        json_object_try_get_bool (rootJ, "resetOnCycle", resetOnCycle);
+        json_object_try_get_int (rootJ, "audioRateDivision", audioRateDivision);
+        audioRateDivision = std::clamp (audioRateDivision, 0, MaxAudioRateDivision);
+        json_object_try_get_int (rootJ, "rewindLength", rewindLength);
+        rewindLength = std::clamp (rewindLength, 1, MaxRewindLength);
+
+        auto seed = static_cast<json_int_t> (randomSeed.load ());
+        json_object_try_get_int (rootJ, "randomSeed", seed);
+        setRandomSeed (static_cast<uint64_t> (seed));
 
         auto triggerInfoJ = json_object_get (rootJ, "triggerInfo");
         if (json_is_array (triggerInfoJ)) {
@@ -21,12 +21,14 @@
 #include "../DSP/ClockDivider.hpp"
 #include "../ModuleBase.hpp"
 #include "../PluginDef.hpp"
+#include "../Telemetry.hpp"
 #include "../UI/CommonWidgets.hpp"
 #include "../UI/WidgetBase.hpp"
 
 #include "AutomataCommon.hpp"
 #include "AutomataLife.hpp"
 #include "EditCommands.hpp"
+#include "StepWorker.hpp"
 
 #include <array>
 #include <atomic>
@@ -40,6 +42,29 @@ namespace OuroborosModules::Modules::Automata {
         void redo () override;
     };
 
+    /** Everything the board display needs, published by the module whenever it changes. */
+    struct AutomataDisplayData {
+        AutomataBoard board;
+        AutomataRules rules;
+        AutomataMode mode = AutomataMode::Play;
+        size_t commandsExecuted = 0;
+    };
+
+    /** The clock, reset and output state of one polyphony channel. */
+    struct AutomataChannel {
+        int stepCount = 0;
+        int cycleLength = 0;
+
+        rack::dsp::SchmittTrigger clockTrigger;
+        rack::dsp::SchmittTrigger resetTrigger;
+        rack::dsp::SchmittTrigger randomizeTrigger;
+
+        rack::dsp::PulseGenerator resetPulse;
+        rack::dsp::PulseGenerator eocPulse;
+        rack::dsp::PulseGenerator outputPulses [TriggerCount];
+        float outputValues [TriggerCount] = { };
+    };
+
     struct AutomataModule : ModuleBase {
         friend AutomataWidget;
         friend AutomataBoardWidget;
@@ -70,12 +95,21 @@ namespace OuroborosModules::Modules::Automata {
             INPUT_LENGTH_ENABLE,
             INPUT_LENGTH_CV,
 
+            INPUT_REVERSE,
+            INPUT_SCRUB,
+
             INPUTS_LEN
         };
         enum OutputId {
             ENUMS (OUTPUT_TRIGGER, TriggerCount),
             OUTPUT_EOC,
 
+            OUTPUT_CYCLE_LENGTH,
+            OUTPUT_STAGNATION,
+
+            ENUMS (OUTPUT_ROW_DENSITY, DensityOutputCount),
+            ENUMS (OUTPUT_COLUMN_DENSITY, DensityOutputCount),
+
             OUTPUTS_LEN
         };
         enum LightId {
@@ -93,10 +127,14 @@ namespace OuroborosModules::Modules::Automata {
         // State
         AutomataMode currentMode;
         bool lengthEnabled;
-        int stepCount;
+        int channelCount;
+        int audioRateCounter;
+        /** Set once the random sequence was restarted this sample, so resetting channels don't all get the same random board. */
+        bool rngReseeded;
 
         DSP::ClockDivider clockParams;
         DSP::ClockDivider clockLights;
+        DSP::ClockDivider clockDisplay;
 
         // Options
         std::array<AutomataTriggerInfo, TriggerCount> triggerInfo;
@@ -104,42 +142,70 @@ namespace OuroborosModules::Modules::Automata {
         bool randomizeOnManualReset;
         bool randomizeOnAutoReset;
         bool momentaryLengthEnable;
+        bool reseedOnReset;
+        bool resetOnCycle;
+        /** Samples per step of the internal audio-rate clock, or 0 to step on the clock input. */
+        int audioRateDivision;
+        /** How many generations the main board remembers to rewind to. Applied by the audio thread. */
+        int rewindLength;
+
+        // Randomness
+        AutomataRandom rng;
+        std::atomic<uint64_t> randomSeed;
+        std::atomic<bool> reseedSignal;
 
         // Inputs
         rack::dsp::SchmittTrigger stepButtonTrigger;
-        rack::dsp::SchmittTrigger clockTrigger;
-
         rack::dsp::SchmittTrigger resetButtonTrigger;
-        rack::dsp::SchmittTrigger resetTrigger;
-
         rack::dsp::SchmittTrigger randomizeButtonTrigger;
-        rack::dsp::SchmittTrigger randomizeTrigger;
 
         rack::dsp::SchmittTrigger lengthButtonTrigger;
         rack::dsp::SchmittTrigger lengthEnableTrigger;
 
-        // Outputs
-        rack::dsp::PulseGenerator resetPulse;
-        rack::dsp::PulseGenerator eocPulse;
-        rack::dsp::PulseGenerator outputPulses [TriggerCount];
-        float outputValues [TriggerCount];
+        rack::dsp::SchmittTrigger reverseTrigger;
+        /** The scrub CV quantized to MaxRewindLength steps, or -1 if it isn't connected. */
+        int lastScrubStep;
+
+        // Channels
+        std::array<AutomataChannel, Constants::MaxPolyphony> channels;
+        /** How many cells each trigger set covers. Only changes with edits, so it's counted once instead of every step. */
+        std::array<int, TriggerCount> triggerLocations;
+        bool triggerLocationsDirty;
+        /** The board version the row and column densities were last counted for. */
+        uint64_t densityVersion;
 
         // Board data
         AutomataLife lifeBoard;
+        AutomataStepJob stepJob;
+        /** The boards of channels 2 and up. Channel 1 plays lifeBoard, which is the one displayed and edited. */
+        std::array<AutomataVoice, Constants::MaxPolyphony - 1> voices;
+
+        AutomataVoice& getVoice (int channel) {
+            assert (channel > 0 && channel < Constants::MaxPolyphony);
+            return voices [channel - 1];
+        }
+        const AutomataBitplane& getChannelLivePlane (int channel) {
+            return channel == 0 ? lifeBoard.getBoard ().getLivePlane () : getVoice (channel).getLivePlane ();
+        }
+        const AutomataBitplane& getChannelLivePlanePrev (int channel) {
+            return channel == 0 ? lifeBoard.getBoard ().getLivePlanePrev () : getVoice (channel).getLivePlanePrev ();
+        }
 
         // Widget communication
         CommandQueue commandQueue;
         std::atomic<bool> updateRulesSignal;
         AutomataRules newRules;
 
+        TelemetryChannel<AutomataDisplayData> displayTelemetry;
+        bool displayDataPending;
+
       public:
         AutomataModule ();
 
         template<class TCommand, typename... TArgs>
         std::shared_ptr<EditCommand> addEditCommand (TArgs &&...args) {
             auto cmd = std::make_shared<TCommand> (std::forward<TArgs> (args) ...);
-            cmd->executed = false;
-            commandQueue.enqueue (cmd, false);
+            cmd->queueIndex = commandQueue.enqueue (cmd, false);
             APP->history->push (new HistoryAutomataEditCommand (this, cmd));
 
             return cmd;
@@ -150,6 +216,14 @@ namespace OuroborosModules::Modules::Automata {
             return triggerInfo [idx];
         }
         AutomataLife& getLifeBoard () { return lifeBoard; }
+        /** UI thread only. */
+        const AutomataDisplayData& getDisplayData () { return displayTelemetry.read (); }
+
+        uint64_t getRandomSeed () { return randomSeed.load (); }
+        void setRandomSeed (uint64_t seed) {
+            randomSeed.store (seed);
+            reseedSignal.store (true);
+        }
 
         void enqueueCommand (std::shared_ptr<EditCommand> command, bool isUndo) { commandQueue.enqueue (command, isUndo); }
         void enqueueRulesUpdate (AutomataRules rules) {
@@ -160,10 +234,13 @@ namespace OuroborosModules::Modules::Automata {
         void initialize ();
 
         void process (const ProcessArgs& args) override;
-        void processReset (bool automatic);
-        void processRandomize ();
-        void processStep (const ProcessArgs& args);
-        void processTriggers ();
+        void processReset (int channel, bool automatic);
+        void processRandomize (int channel);
+        void processStep (const ProcessArgs& args, int channel);
+        void processRewind ();
+        void processTriggers (int channel);
+        void processDensities ();
+        void countTriggerLocations ();
 
         void onReset (const ResetEvent& e) override;
 
@@ -175,12 +252,14 @@ namespace OuroborosModules::Modules::Automata {
       private:
         Widgets::EmblemWidget* emblemWidget = nullptr;
         AutomataRulesWidget* rulesWidget = nullptr;
+        AutomataBoardWidget* boardWidget = nullptr;
 
       public:
         AutomataWidget (AutomataModule* module);
 
         AutomataModule* getAutomata () { return moduleT; }
         AutomataRulesWidget* getRulesWidget () { return rulesWidget; }
+        AutomataBoardWidget* getBoardWidget () { return boardWidget; }
         int getDisplayLayer () { return 1; } // TODO: Add options for different layers?
 
       protected:
@@ -188,6 +267,9 @@ namespace OuroborosModules::Modules::Automata {
 
         void onChangeEmblem (EmblemId emblemId) override;
         void appendContextMenu (rack::ui::Menu* menu) override;
+        void generateAudioRateContextMenu (rack::ui::Menu* menu);
+        void generateRewindContextMenu (rack::ui::Menu* menu);
+        void generateBoardSizeContextMenu (rack::ui::Menu* menu);
         void generateRulesContextMenu (rack::ui::Menu* menu);
         void generateTriggerContextMenu (rack::ui::Menu* menu, int i);
     };
@@ -195,7 +277,6 @@ namespace OuroborosModules::Modules::Automata {
     struct AutomataBoardWidget : rack_themer::ThemedWidgetBase<rack::widget::Widget> {
       private:
         AutomataWidget* panelWidget = nullptr;
-        AutomataLifeUpdateIndex lifeUpdateIndex = 0;
 
         // Edit data
         bool editing = false;
@@ -206,27 +287,58 @@ namespace OuroborosModules::Modules::Automata {
 
         // Internal board
         AutomataBoard internalBoard;
+        AutomataMode internalMode = AutomataMode::Play;
+
+        // View data
+        float viewZoom = 1.f;
+        /** The top left corner of the view, in cells. */
+        rack::math::Vec viewOffset;
+        bool panning = false;
 
         // Cached data
         AutomataRules lastRules;
         std::string ruleString;
         float lastFooterSize = 0;
+        /** Holds the drawn cells, so they're only redrawn when something changed. Drawn by hand on the display layer. */
+        rack::widget::FramebufferWidget* cellsFramebuffer = nullptr;
+        rack::widget::Widget* cellsWidget = nullptr;
 
         void enterEditMode (AutomataCell mask, int cellX, int cellY, bool set);
         void editModeMouseMoved (int cellX, int cellY);
         void exitEditMode ();
 
+        void clampView ();
+
       public:
+        static constexpr float MaxViewZoom = 16.f;
+
         AutomataBoardWidget (rack::math::Vec size, AutomataWidget* panelWidget);
+        ~AutomataBoardWidget ();
+
+        /** The board as currently displayed, including edits the module hasn't executed yet. */
+        const AutomataBoard& getBoard () const { return internalBoard; }
+
+        float getViewZoom () const { return viewZoom; }
+        rack::math::Vec getViewOffset () const { return viewOffset; }
+        /** Zooming only makes sense on boards larger than the default. */
+        bool canZoom () const {
+            return internalBoard.getWidth () > DefaultBoardWidth || internalBoard.getHeight () > DefaultBoardHeight;
+        }
+        void resetView ();
+        /** Must be called whenever anything the cells are drawn from changes. */
+        void invalidateCells () { cellsFramebuffer->setDirty (); }
 
         void drawBoard (const DrawArgs& args);
+        void drawCells (const DrawArgs& args);
 
         void step () override;
         void draw (const DrawArgs& args) override;
         void drawLayer (const DrawArgs& args, int layer) override;
         void onButton (const rack::event::Button& e) override;
         void onDragHover (const rack::event::DragHover& e) override;
+        void onDragMove (const rack::event::DragMove& e) override;
         void onDragEnd (const rack::event::DragEnd& e) override;
+        void onHoverScroll (const rack::event::HoverScroll& e) override;
     };
 
     struct AutomataRulesWidget : rack_themer::ThemedWidgetBase<rack::widget::Widget> {
@@ -263,7 +375,7 @@ namespace OuroborosModules::Modules::Automata {
             moduleId = module->id;
             name = "change automata rules";
 
-            oldRules = module->getLifeBoard ().getRules ();
+            oldRules = module->getDisplayData ().rules;
             newRules = rules;
             redo ();
         }
@@ -26,20 +26,173 @@ namespace OuroborosModules::Modules::Automata {
         clear ();
     }
 
+    void AutomataBitplane::resize (int newWidth, int newHeight) {
+        auto newRowWords = newWidth / BoardWordBits;
+        auto copyWords = std::min (rowWords, newRowWords);
+        auto copyRows = std::min (height, newHeight);
+
+        // Move the rows in place. Rows only move towards the start when they get shorter, and towards the end otherwise.
+        auto data = words.data ();
+        if (newRowWords <= rowWords) {
+            for (int y = 0; y < copyRows; y++)
+                std::copy_n (data + y * rowWords, copyWords, data + y * newRowWords);
+        } else {
+            for (int y = copyRows - 1; y >= 0; y--) {
+                auto source = data + y * rowWords;
+                auto destination = data + y * newRowWords;
+                std::copy_backward (source, source + copyWords, destination + copyWords);
+                std::fill (destination + copyWords, destination + newRowWords, 0);
+            }
+        }
+        std::fill (data + copyRows * newRowWords, data + newHeight * newRowWords, 0);
+
+        rowWords = newRowWords;
+        height = newHeight;
+    }
+
+    uint64_t AutomataBitplane::hash () const {
+        static constexpr uint64_t OffsetBasis = 0xCBF29CE484222325ull;
+        static constexpr uint64_t Prime = 0x100000001B3ull;
+
+        auto hash = (OffsetBasis ^ static_cast<uint64_t> (rowWords)) * Prime;
+        hash = (hash ^ static_cast<uint64_t> (height)) * Prime;
+        for (int i = 0; i < getWordCount (); i++)
+            hash = (hash ^ words [i]) * Prime;
+
+        return hash;
+    }
+
+    void AutomataBoard::resize (int width, int height) {
+        assert (isValidSize (width, height));
+        for (auto& plane : planes)
+            plane.resize (width, height);
+    }
+
+    int AutomataBoard::planeFromFlag (AutomataCell flag) {
+        switch (flag) {
+            case AutomataCell::FLAG_LiveA: return 0;
+            case AutomataCell::FLAG_LiveB: return 1;
+            case AutomataCell::FLAG_SeedSet: return 2;
+
+            default:
+                auto triggerIndex = triggerFromCell (flag);
+                assert (triggerIndex > 0 && "Invalid plane flag.");
+                return 2 + std::max (triggerIndex, 1);
+        }
+    }
+
+    AutomataCell AutomataBoard::at (int x, int y) const {
+        auto cell = AutomataCell::None;
+
+        cell |= planes [0].get (x, y) ? AutomataCell::FLAG_LiveA : AutomataCell::None;
+        cell |= planes [1].get (x, y) ? AutomataCell::FLAG_LiveB : AutomataCell::None;
+        cell |= planes [2].get (x, y) ? AutomataCell::FLAG_SeedSet : AutomataCell::None;
+        for (int i = 0; i < TriggerCount; i++)
+            cell |= planes [3 + i].get (x, y) ? cellFromTriggerIndex (i) : AutomataCell::None;
+
+        return cell;
+    }
+
+    void AutomataBoard::set (int x, int y, AutomataCell cell) {
+        planes [0].set (x, y, testCellFlag (cell, AutomataCell::FLAG_LiveA));
+        planes [1].set (x, y, testCellFlag (cell, AutomataCell::FLAG_LiveB));
+        planes [2].set (x, y, testCellFlag (cell, AutomataCell::FLAG_SeedSet));
+        for (int i = 0; i < TriggerCount; i++)
+            planes [3 + i].set (x, y, testCellFlag (cell, cellFromTriggerIndex (i)));
+    }
+
+    /*
+     * Serialization
+     *
+     * Version 2 stores every plane as base64 encoded runs of words: a varint count of empty words,
+     * a varint count of literal words, then the literal words in little endian, repeated until the plane is full.
+     * Boards without a version store an array of rows of cell flags instead.
+     */
+    static constexpr int BoardFormatVersion = 2;
+
+    void writeVarint (std::vector<uint8_t>& bytes, uint32_t value) {
+        while (value >= 0x80) {
+            bytes.push_back (static_cast<uint8_t> (value | 0x80));
+            value >>= 7;
+        }
+        bytes.push_back (static_cast<uint8_t> (value));
+    }
+
+    bool readVarint (const std::vector<uint8_t>& bytes, size_t& pos, uint32_t& value) {
+        value = 0;
+        for (int shift = 0; shift < 32 && pos < bytes.size (); shift += 7) {
+            auto byte = bytes [pos++];
+            value |= static_cast<uint32_t> (byte & 0x7F) << shift;
+            if ((byte & 0x80) == 0)
+                return true;
+        }
+        return false;
+    }
+
+    std::string encodePlane (const AutomataBitplane& plane) {
+        std::vector<uint8_t> bytes;
+        auto words = plane.data ();
+        auto wordCount = plane.getWordCount ();
+        for (int wordI = 0; wordI < wordCount;) {
+            auto emptyStart = wordI;
+            while (wordI < wordCount && words [wordI] == 0)
+                wordI++;
+            auto literalStart = wordI;
+            while (wordI < wordCount && words [wordI] != 0)
+                wordI++;
+
+            writeVarint (bytes, literalStart - emptyStart);
+            writeVarint (bytes, wordI - literalStart);
+            for (int i = literalStart; i < wordI; i++) {
+                for (int byteI = 0; byteI < static_cast<int> (sizeof (BoardRow)); byteI++)
+                    bytes.push_back (static_cast<uint8_t> (words [i] >> (byteI * 8)));
+            }
+        }
+
+        return rack::string::toBase64 (bytes.data (), bytes.size ());
+    }
+
+    bool decodePlane (const std::string& encoded, AutomataBitplane& plane) {
+        auto bytes = rack::string::fromBase64 (encoded);
+        auto words = plane.data ();
+        auto wordCount = static_cast<uint32_t> (plane.getWordCount ());
+
+        size_t pos = 0;
+        uint32_t wordI = 0;
+        while (pos < bytes.size ()) {
+            uint32_t emptyCount, literalCount;
+            if (!readVarint (bytes, pos, emptyCount) || !readVarint (bytes, pos, literalCount))
+                return false;
+            if (emptyCount > wordCount - wordI || literalCount > wordCount - wordI - emptyCount)
+                return false;
+            if (bytes.size () - pos < literalCount * sizeof (BoardRow))
+                return false;
+
+            std::fill_n (words + wordI, emptyCount, 0);
+            wordI += emptyCount;
+            for (uint32_t i = 0; i < literalCount; i++, wordI++) {
+                BoardRow word = 0;
+                for (int byteI = 0; byteI < static_cast<int> (sizeof (BoardRow)); byteI++)
+                    word |= static_cast<BoardRow> (bytes [pos++]) << (byteI * 8);
+                words [wordI] = word;
+            }
+        }
+
+        return wordI == wordCount;
+    }
+
     json_t* AutomataBoard::dataToJson () const {
         auto rootJ = json_object ();
 
+        json_object_set_new_int (rootJ, "version", BoardFormatVersion);
         json_object_set_new_bool (rootJ, "boardFlip", boardFlip);
+        json_object_set_new_int (rootJ, "width", getWidth ());
+        json_object_set_new_int (rootJ, "height", getHeight ());
 
-        auto dataJ = json_array ();
-        for (int y = 0; y < BoardHeight; y++) {
-            auto rowJ = json_array ();
-            for (int x = 0; x < BoardWidth; x++)
-                json_array_append_new (rowJ, json_integer (static_cast<AutomataCellBase> (at (x, y))));
-
-            json_array_append_new (dataJ, rowJ);
-        }
-        json_object_set_new (rootJ, "dataArray", dataJ);
+        auto planesJ = json_array ();
+        for (const auto& plane : planes)
+            json_array_append_new (planesJ, json_string (encodePlane (plane).c_str ()));
+        json_object_set_new (rootJ, "planes", planesJ);
 
         return rootJ;
     }
@@ -48,26 +201,61 @@ namespace OuroborosModules::Modules::Automata {
         if (!json_is_object (rootJ))
             return false;
 
+        auto version = 1;
+        json_object_try_get_int (rootJ, "version", version);
+        if (version > BoardFormatVersion)
+            return false;
+
         json_object_try_get_bool (rootJ, "boardFlip", boardFlip);
 
+        // Boards saved before sizes were configurable don't store their size.
+        auto width = DefaultBoardWidth;
+        auto height = DefaultBoardHeight;
+        json_object_try_get_int (rootJ, "width", width);
+        json_object_try_get_int (rootJ, "height", height);
+        if (!isValidSize (width, height))
+            return false;
+
+        if (version < 2)
+            return dataFromJson_Legacy (rootJ, width, height);
+
+        auto planesJ = json_object_get (rootJ, "planes");
+        if (!json_is_array (planesJ) || json_array_size (planesJ) != static_cast<size_t> (PlaneCount))
+            return false;
+
+        resize (width, height);
+        for (int i = 0; i < PlaneCount; i++) {
+            auto planeJ = json_array_get (planesJ, i);
+            if (!json_is_string (planeJ) || !decodePlane (json_string_value (planeJ), planes [i])) {
+                clear ();
+                return false;
+            }
+        }
+
+        return true;
+    }
+
+    bool AutomataBoard::dataFromJson_Legacy (json_t* rootJ, int width, int height) {
         auto dataJ = json_object_get (rootJ, "dataArray");
-        if (!json_is_array (dataJ) || json_array_size (dataJ) != BoardHeight)
+        if (!json_is_array (dataJ) || json_array_size (dataJ) != static_cast<size_t> (height))
             return false;
 
-        for (int y = 0; y < BoardHeight; y++) {
+        resize (width, height);
+        clear ();
+        for (int y = 0; y < height; y++) {
             auto rowJ = json_array_get (dataJ, y);
-            if (json_array_size (rowJ) != BoardWidth)
+            if (json_array_size (rowJ) != static_cast<size_t> (width))
                 return false;
 
-            for (int x = 0; x < BoardWidth; x++) {
+            for (int x = 0; x < width; x++) {
                 auto cellJ = json_array_get (rowJ, x);
                 if (!json_is_integer (cellJ))
                     return false;
 
-                at (x, y) = static_cast<AutomataCell> (json_integer_value (cellJ));
+                set (x, y, static_cast<AutomataCell> (json_integer_value (cellJ)));
             }
         }
 
-        return rootJ;
+        return true;
     }
 }
\ No newline at end of file
@@ -21,6 +21,8 @@
 
 #include "../JsonUtils.hpp"
 
+#include <fmt/format.h>
+
 namespace OuroborosModules::Modules::Automata {
     /*
      * Preset rules
@@ -69,6 +71,41 @@ namespace OuroborosModules::Modules::Automata {
         return std::make_pair ("#ERROR", AutomataRules ());
     }
 
+    std::pair<std::string, AutomataRules> calculatePresetRule (
+        std::string name,
+        std::vector<uint8_t> birth, std::vector<uint8_t> survival,
+        int states
+    ) {
+        auto rulePair = calculatePresetRule (name, birth, survival);
+        rulePair.second.setStates (states);
+
+        return rulePair;
+    }
+
+    std::pair<std::string, AutomataRules> calculatePresetRule_LargerThanLife (
+        std::string name,
+        int radius, bool countCenter,
+        int birthMin, int birthMax,
+        int survivalMin, int survivalMax
+    ) {
+        auto rules = AutomataRules ();
+        rules.setRadius (radius);
+        rules.setCountCenter (countCenter);
+
+        if (rules.getRadius () != radius) {
+            LOG_FATAL (FMT_STRING ("Error in preset rule \"{}\": Radius {} > {}"), name, radius, MaxRuleRadius);
+            return std::make_pair ("#ERROR", AutomataRules ());
+        } else if (birthMin > birthMax || survivalMin > survivalMax || std::max (birthMax, survivalMax) > rules.getMaxNeighbors ()) {
+            LOG_FATAL (FMT_STRING ("Error in preset rule \"{}\": Invalid range"), name);
+            return std::make_pair ("#ERROR", AutomataRules ());
+        }
+
+        rules.setBirthRange (birthMin, birthMax);
+        rules.setSurvivalRange (survivalMin, survivalMax);
+
+        return std::make_pair (name, rules);
+    }
+
     std::vector<std::pair<std::string, AutomataRules>> presetRules = {
         calculatePresetRule ("Conway's Game of Life (Default)", { 3 }, { 2, 3 }),
         calculatePresetRule ("34 Life", { 3, 4 }, { 3, 4, }),
@@ -80,6 +117,18 @@ namespace OuroborosModules::Modules::Automata {
         calculatePresetRule ("Day & Night", { 3, 6, 7, 8 }, { 3, 4, 6, 7, 8 }),
         calculatePresetRule ("Morley/Move", { 3, 6, 8 }, { 2, 4, 5 }),
         calculatePresetRule ("Anneal", { 4, 6, 7, 8 }, { 3, 5, 6, 7, 8 }),
+
+        // Generations
+        calculatePresetRule ("Brian's Brain", { 2 }, { }, 3),
+        calculatePresetRule ("Star Wars", { 2 }, { 3, 4, 5 }, 4),
+        calculatePresetRule ("Frogs", { 3, 4 }, { 1, 2 }, 3),
+        calculatePresetRule ("Sticks", { 2 }, { 3, 4, 5, 6 }, 6),
+        calculatePresetRule ("Lava", { 4, 5, 6, 7, 8 }, { 1, 2, 3, 4, 5 }, 8),
+
+        // Larger than Life
+        calculatePresetRule_LargerThanLife ("Bosco's Rule", 5, true, 34, 45, 34, 58),
+        calculatePresetRule_LargerThanLife ("Majority", 4, true, 41, 81, 41, 81),
+        calculatePresetRule_LargerThanLife ("Waffle", 7, true, 75, 170, 100, 200),
     };
 
     /*
@@ -131,9 +180,29 @@ namespace OuroborosModules::Modules::Automata {
         maskField = (maskField & ~flagMask) | (set ? flagMask : 0);
     }
 
+    void AutomataRules::setBirthRange (int min, int max) {
+        birthMin = static_cast<uint8_t> (std::clamp (min, 0, 255));
+        birthMax = static_cast<uint8_t> (std::clamp (max, 0, 255));
+    }
+
+    void AutomataRules::setSurvivalRange (int min, int max) {
+        survivalMin = static_cast<uint8_t> (std::clamp (min, 0, 255));
+        survivalMax = static_cast<uint8_t> (std::clamp (max, 0, 255));
+    }
+
     std::string AutomataRules::getRuleString () {
-        // Size = B012345678/S012345678 + extra byte
-        static constexpr int MaxLength = 22;
+        // Uses the same notation as Golly, except 2-state rules leave out the state count.
+        if (radius > 1) {
+            auto statesString = states > 2 ? fmt::format (FMT_STRING ("C{},"), states) : "";
+            return fmt::format (
+                FMT_STRING ("R{},{}M{},S{}..{},B{}..{}"),
+                radius, statesString, countCenter ? 1 : 0,
+                survivalMin, survivalMax, birthMin, birthMax
+            );
+        }
+
+        // Size = B012345678/S012345678/C16 + extra byte
+        static constexpr int MaxLength = 26;
         struct TextBuffer {
             char buffer [MaxLength];
             std::size_t textLen = 0;
@@ -161,6 +230,13 @@ namespace OuroborosModules::Modules::Automata {
             if ((survivalMask & neighbourIdx) != 0)
                 textBuf.append ('0' + i);
         }
+        if (states > 2) {
+            textBuf.append ('/');
+            textBuf.append ('C');
+            if (states >= 10)
+                textBuf.append ('0' + states / 10);
+            textBuf.append ('0' + states % 10);
+        }
 
         return textBuf.flush ();
     }
@@ -170,6 +246,13 @@ namespace OuroborosModules::Modules::Automata {
 
         json_object_set_new_int (rootJ, "birthMask", birthMask);
         json_object_set_new_int (rootJ, "survivalMask", survivalMask);
+        json_object_set_new_int (rootJ, "radius", radius);
+        json_object_set_new_int (rootJ, "states", states);
+        json_object_set_new_bool (rootJ, "countCenter", countCenter);
+        json_object_set_new_int (rootJ, "birthMin", birthMin);
+        json_object_set_new_int (rootJ, "birthMax", birthMax);
+        json_object_set_new_int (rootJ, "survivalMin", survivalMin);
+        json_object_set_new_int (rootJ, "survivalMax", survivalMax);
 
         return rootJ;
     }
@@ -180,6 +263,21 @@ namespace OuroborosModules::Modules::Automata {
 
         json_object_try_get_int (rootJ, "birthMask", birthMask);
         json_object_try_get_int (rootJ, "survivalMask", survivalMask);
+        json_object_try_get_bool (rootJ, "countCenter", countCenter);
+
+        int newRadius = radius, newStates = states;
+        json_object_try_get_int (rootJ, "radius", newRadius);
+        json_object_try_get_int (rootJ, "states", newStates);
+        setRadius (newRadius);
+        setStates (newStates);
+
+        int newBirthMin = birthMin, newBirthMax = birthMax, newSurvivalMin = survivalMin, newSurvivalMax = survivalMax;
+        json_object_try_get_int (rootJ, "birthMin", newBirthMin);
+        json_object_try_get_int (rootJ, "birthMax", newBirthMax);
+        json_object_try_get_int (rootJ, "survivalMin", newSurvivalMin);
+        json_object_try_get_int (rootJ, "survivalMax", newSurvivalMax);
+        setBirthRange (newBirthMin, newBirthMax);
+        setSurvivalRange (newSurvivalMin, newSurvivalMax);
 
         return true;
     }
@@ -209,7 +307,7 @@ namespace OuroborosModules::Modules::Automata {
     /*
      * Default board
      */
-    int DefaultBoard_Seed [BoardHeight] [BoardWidth] = {
+    int DefaultBoard_Seed [DefaultBoardHeight] [DefaultBoardWidth] = {
         { 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, },
         { 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, },
         { 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, },
@@ -20,6 +20,7 @@
 
 #include "../PluginDef.hpp"
 
+#include <algorithm>
 #include <array>
 #include <atomic>
 #include <memory>
@@ -40,13 +41,30 @@ namespace OuroborosModules::Modules::Automata {
     struct AutomataBoardWidget;
     struct AutomataRulesWidgetBitButton;
 
-    using AutomataLifeUpdateIndex = uint32_t;
-
-    static constexpr int BoardWidth = 32;
-    static constexpr int BoardHeight = 20;
+    static constexpr int DefaultBoardWidth = 32;
+    static constexpr int DefaultBoardHeight = 20;
+    /** Board widths are whole multiples of this. */
+    static constexpr int BoardWordBits = 32;
+    static constexpr int MaxBoardWidth = 256;
+    static constexpr int MaxBoardHeight = 256;
+    static constexpr int MinBoardHeight = 4;
+    static constexpr int MaxBoardWords = MaxBoardWidth / BoardWordBits * MaxBoardHeight;
     static constexpr int TriggerCount = 8;
+    /** How many cables the row and column densities are each split over. */
+    static constexpr int DensityOutputCount = 2;
     static constexpr int MaxSequenceLength = 64;
+    /** The slowest internal clock in audio-rate mode, in samples per step. */
+    static constexpr int MaxAudioRateDivision = 256;
+    /** The most generations that can be rewound. Larger boards get fewer, see AutomataRewindBuffer. */
+    static constexpr int MaxRewindLength = 4096;
+    static constexpr int DefaultRewindLength = 1024;
+    /** Output voltage per generation of a detected cycle's period. */
+    static constexpr float CycleLengthVoltage = .1f;
     static constexpr int NeighborsCount = 9;
+    /** Larger than Life neighborhoods reach up to this many cells away. */
+    static constexpr int MaxRuleRadius = 7;
+    /** Generations rules have up to this many cell states, including live and dead. */
+    static constexpr int MaxRuleStates = 16;
 
     static constexpr float BoardMargin = 8;
     static constexpr float BoardSpacing = 1;
@@ -117,17 +135,30 @@ namespace OuroborosModules::Modules::Automata {
      * AutomataRules
      */
     using RuleMaskType = uint16_t;
+    /**
+     * Outer-totalistic rules. With a radius of 1 the birth and survival masks apply to the 8 neighbors.
+     * Larger radiuses are Larger than Life rules, which count the neighborhood against the birth and survival ranges.
+     * With more than 2 states they're Generations rules: dying cells decay through the extra states before they can be born again.
+     */
     struct AutomataRules {
         static constexpr RuleMaskType BitMask = (1 << (NeighborsCount)) - 1;
       private:
         RuleMaskType birthMask;
         RuleMaskType survivalMask;
 
+        uint8_t radius;
+        uint8_t states;
+        bool countCenter;
+        uint8_t birthMin, birthMax;
+        uint8_t survivalMin, survivalMax;
+
         bool getFlag (RuleMaskType maskField, int idx) const;
         void setFlag (RuleMaskType& maskField, int idx, bool set);
 
       public:
-        AutomataRules () : birthMask (0), survivalMask (0) { }
+        AutomataRules ()
+            : birthMask (0), survivalMask (0), radius (1), states (2), countCenter (false),
+              birthMin (0), birthMax (0), survivalMin (0), survivalMax (0) { }
 
         RuleMaskType getBirthMask () const { return birthMask; }
         RuleMaskType getSurvivalMask () const { return survivalMask; }
@@ -138,12 +169,42 @@ namespace OuroborosModules::Modules::Automata {
         bool getSurvivalFlag (int idx) const { return getFlag (survivalMask, idx); }
         void setSurvivalFlag (int idx, bool set) { setFlag (survivalMask, idx, set); }
 
+        int getRadius () const { return radius; }
+        void setRadius (int newRadius) { radius = static_cast<uint8_t> (std::clamp (newRadius, 1, MaxRuleRadius)); }
+        bool isLargerThanLife () const { return radius > 1; }
+        /** The largest possible neighbor count for the current radius. */
+        int getMaxNeighbors () const { return (radius * 2 + 1) * (radius * 2 + 1) - (countCenter ? 0 : 1); }
+
+        int getStates () const { return states; }
+        void setStates (int newStates) { states = static_cast<uint8_t> (std::clamp (newStates, 2, MaxRuleStates)); }
+        bool isGenerations () const { return states > 2; }
+
+        /** Whether Larger than Life rules count the cell itself as a neighbor. */
+        bool getCountCenter () const { return countCenter; }
+        void setCountCenter (bool count) { countCenter = count; }
+
+        int getBirthMin () const { return birthMin; }
+        int getBirthMax () const { return birthMax; }
+        void setBirthRange (int min, int max);
+        int getSurvivalMin () const { return survivalMin; }
+        int getSurvivalMax () const { return survivalMax; }
+        void setSurvivalRange (int min, int max);
+
         std::string getRuleString ();
 
         json_t* dataToJson () const;
         bool dataFromJson (json_t* rootJ);
 
         bool operator== (const AutomataRules& rhs) const {
+            if (radius != rhs.radius || states != rhs.states)
+                return false;
+
+            if (radius > 1) {
+                return countCenter == rhs.countCenter &&
+                       birthMin    == rhs.birthMin    && birthMax    == rhs.birthMax &&
+                       survivalMin == rhs.survivalMin && survivalMax == rhs.survivalMax;
+            }
+
             return (birthMask    & BitMask) == (rhs.birthMask    & BitMask) &&
                    (survivalMask & BitMask) == (rhs.survivalMask & BitMask);
         }
@@ -175,5 +236,5 @@ namespace OuroborosModules::Modules::Automata {
     /*
      * Default board
      */
-    extern int DefaultBoard_Seed [BoardHeight] [BoardWidth];
+    extern int DefaultBoard_Seed [DefaultBoardHeight] [DefaultBoardWidth];
 }
\ No newline at end of file
@@ -26,105 +26,471 @@ namespace OuroborosModules::Modules::Automata {
     }
 
     void AutomataLife::markUpdated () {
+        restartHistory ();
+
+        // Edits start a new timeline from the rewound generation. Only the live cells are recorded,
+        // so edits to the seed or trigger sets don't add a repeated generation.
+        rewindBuffer.dropNewest (rewindPosition);
+        rewindPosition = 0;
+        if (!rewindBuffer.isNewest (board.getLivePlane ())) {
+            rewindBuffer.push (board.getLivePlane ());
+            decay.clear ();
+        }
+
+        markStepped ();
+    }
+
+    void AutomataLife::markStepped () {
         updated = true;
+        version++;
     }
 
-    bool AutomataLife::handleUpdated () {
-        if (updated) {
-            ++updateIdx;
-            updated = false;
-            return true;
+    void AutomataHistory::push (const AutomataBitplane& generation) {
+        auto hash = generation.hash ();
+
+        // Search from the newest generation, so the shortest period is found. A matching hash counts as a repeat,
+        // and the recorded frames are compared to the generations before any of them is replayed.
+        auto newCycleLength = 0;
+        for (int age = 0; age < count; age++) {
+            if (hashes [indexFromAge (age)] == hash) {
+                newCycleLength = age + 1;
+                break;
+            }
+        }
+
+        if (newCycleLength != cycleLength)
+            restartFrames ();
+        cycleRepeats = newCycleLength > 0 ? (newCycleLength == cycleLength ? cycleRepeats + 1 : 1) : 0;
+        cycleLength = newCycleLength;
+
+        head = (head + 1) % Length;
+        hashes [head] = hash;
+        count = std::min (count + 1, Length);
+
+        if (cycleLength > 0)
+            recordFrame (generation);
+    }
+
+    void AutomataHistory::recordFrame (const AutomataBitplane& generation) {
+        auto wordCount = generation.getWordCount ();
+        if (wordCount * cycleLength > FrameWordBudget)
+            return;
+
+        if (frameCount == 0)
+            frameWords = wordCount;
+
+        // The first period is recorded. After that, each generation lands on the frame from one period ago.
+        auto frame = &frames [frameCursor * frameWords];
+        if (frameCount < cycleLength) {
+            std::copy_n (generation.data (), frameWords, frame);
+            frameCount++;
+        } else if (framesVerified || std::equal (frame, frame + frameWords, generation.data ()))
+            framesVerified = true;
+        else {
+            // Different generations with the same hash, so it wasn't a cycle after all.
+            cycleLength = 0;
+            cycleRepeats = 0;
+            return restartFrames ();
+        }
+
+        frameCursor = (frameCursor + 1) % cycleLength;
+    }
+
+    void AutomataHistory::getCycleNext (AutomataBitplane& destination) const {
+        assert (framesVerified && destination.getWordCount () == frameWords);
+        std::copy_n (&frames [frameCursor * frameWords], frameWords, destination.data ());
+    }
+
+    void AutomataDecay::push (const BoardRow* previous, const BoardRow* current, int rowWords, int height) {
+        // Cells that died on a board of another size don't mean anything anymore.
+        if (rowWords != this->rowWords || height != this->height) {
+            this->rowWords = rowWords;
+            this->height = height;
+            for (auto& agePlane : agePlanes)
+                agePlane.resize (rowWords * BoardWordBits, height);
+            empty = true;
+        }
+
+        auto wordCount = rowWords * height;
+        if (empty) {
+            for (auto& agePlane : agePlanes)
+                std::fill_n (agePlane.data (), wordCount, ~BoardRow (0));
+            empty = false;
+        }
+
+        for (int wordI = 0; wordI < wordCount; wordI++) {
+            // Age every cell by one, except the ones already at the maximum age.
+            auto carry = ~BoardRow (0);
+            for (auto& agePlane : agePlanes)
+                carry &= agePlane.data () [wordI];
+            carry = ~carry;
+
+            // Cells that just died start over at age 0.
+            auto died = previous [wordI] & ~current [wordI];
+            for (auto& agePlane : agePlanes) {
+                auto& ageWord = agePlane.data () [wordI];
+                auto ageBit = ageWord;
+                ageWord = (ageBit ^ carry) & ~died;
+                carry &= ageBit;
+            }
+        }
+    }
+
+    const AutomataBitplane* AutomataDecay::getRefractory (const AutomataRules& rules) {
+        auto decayAges = rules.getStates () - 2;
+        if (decayAges < 1 || empty)
+            return nullptr;
+
+        if (refractory.getRowWords () != rowWords || refractory.getHeight () != height)
+            refractory.resize (rowWords * BoardWordBits, height);
+
+        // Compares every cell's age to the decay length, from the highest bit down.
+        auto refractoryWords = refractory.data ();
+        for (int wordI = 0; wordI < refractory.getWordCount (); wordI++) {
+            auto less = BoardRow (0);
+            auto equal = ~BoardRow (0);
+            for (int bit = AgeBits - 1; bit >= 0; bit--) {
+                auto ageBit = agePlanes [bit].data () [wordI];
+                if ((decayAges >> bit) & 1) {
+                    less |= equal & ~ageBit;
+                    equal &= ageBit;
+                } else
+                    equal &= ~ageBit;
+            }
+
+            refractoryWords [wordI] = less;
         }
 
-        return false;
+        return &refractory;
+    }
+
+    void AutomataRewindBuffer::push (const AutomataBitplane& generation) {
+        if (generation.getRowWords () != rowWords || generation.getHeight () != height) {
+            rowWords = generation.getRowWords ();
+            height = generation.getHeight ();
+            clear ();
+        }
+
+        capacity = std::min (length, WordBudget / generation.getWordCount ());
+        if (count > capacity)
+            clear ();
+
+        head = (head + 1) % capacity;
+        std::copy_n (generation.data (), generation.getWordCount (), &words [head * generation.getWordCount ()]);
+        count = std::min (count + 1, capacity);
+    }
+
+    void AutomataRewindBuffer::dropNewest (int dropCount) {
+        dropCount = std::min (dropCount, count);
+        if (dropCount < 1)
+            return;
+
+        head = indexFromAge (dropCount);
+        count -= dropCount;
+    }
+
+    bool AutomataRewindBuffer::isNewest (const AutomataBitplane& generation) const {
+        if (count < 1 || generation.getRowWords () != rowWords || generation.getHeight () != height)
+            return false;
+
+        return std::equal (generation.data (), generation.data () + generation.getWordCount (), getGeneration (0));
     }
 
-    bool AutomataLife::checkUpdated (AutomataLifeUpdateIndex& index) {
-        auto curIndex = updateIdx.load ();
-        auto ret = index < curIndex;
+    void AutomataRewindBuffer::get (int age, AutomataBitplane& destination) const {
+        assert (age >= 0 && age < count);
+        assert (destination.getRowWords () == rowWords && destination.getHeight () == height);
+
+        std::copy_n (getGeneration (age), destination.getWordCount (), destination.data ());
+    }
 
-        index = curIndex;
+    bool AutomataLife::handleUpdated () {
+        auto ret = updated;
+        updated = false;
         return ret;
     }
 
     void AutomataLife::initialize () {
+        rewindBuffer.clear ();
+        rewindPosition = 0;
+
         auto defaultRules = AutomataRules ();
         defaultRules.setBirthFlag (3, true);
         defaultRules.setSurvivalFlag (2, true);
         defaultRules.setSurvivalFlag (3, true);
         setRules (defaultRules);
 
+        board.resize (DefaultBoardWidth, DefaultBoardHeight);
         board.clear ();
-        for (int y = 0; y < BoardHeight; y++) {
-            for (int x = 0; x < BoardWidth; x++) {
-                if (DefaultBoard_Seed [y] [x] == 1)
-                    board.at (x, y) = AutomataCell::FLAG_SeedSet | board.getLiveFlag ();
-                else
-                    board.at (x, y) = AutomataCell::None;
-            }
+        auto& seedPlane = board.getPlane (AutomataCell::FLAG_SeedSet);
+        for (int y = 0; y < DefaultBoardHeight; y++) {
+            for (int x = 0; x < DefaultBoardWidth; x++)
+                seedPlane.set (x, y, DefaultBoard_Seed [y] [x] == 1);
         }
+        board.getLivePlane () = seedPlane;
 
         markUpdated ();
     }
 
     void AutomataLife::reset () {
-        auto liveFlag = board.getLiveFlag ();
+        board.getLivePlane () = board.getPlane (AutomataCell::FLAG_SeedSet);
+        board.getLivePlanePrev ().clear ();
 
-        for (auto& cell : board) {
-            cell &= ~AutomataCell::MASK_Live;
-            cell |= testCellFlag (cell, AutomataCell::FLAG_SeedSet) ? liveFlag : AutomataCell::None;
+        markUpdated ();
+    }
+
+    void randomizePlane (AutomataBitplane& plane, float density, AutomataRandom& rng) {
+        static constexpr int LaneCount = AutomataRandom::Lanes;
+        static_assert (BoardWordBits % LaneCount == 0, "Board words must fit evenly into random batches");
+
+        float randomValues [LaneCount];
+        auto words = plane.data ();
+        for (int wordI = 0; wordI < plane.getWordCount (); wordI++) {
+            BoardRow word = 0;
+            for (int bitI = 0; bitI < BoardWordBits; bitI += LaneCount) {
+                rng.nextUniform (randomValues);
+
+                for (int i = 0; i < LaneCount; i++)
+                    word |= BoardRow (randomValues [i] < density) << (bitI + i);
+            }
+            words [wordI] = word;
         }
+    }
+
+    void AutomataLife::randomize (float density, AutomataRandom& rng) {
+        randomizePlane (board.getLivePlane (), density, rng);
+        board.getLivePlanePrev ().clear ();
 
         markUpdated ();
     }
 
-    void AutomataLife::randomize (float density) {
-        auto liveFlag = board.getLiveFlag ();
+    /*
+     * Bit-sliced neighbor counting
+     */
+    inline void halfAdd (BoardRow a, BoardRow b, BoardRow& sum, BoardRow& carry) {
+        sum = a ^ b;
+        carry = a & b;
+    }
+
+    inline void fullAdd (BoardRow a, BoardRow b, BoardRow c, BoardRow& sum, BoardRow& carry) {
+        auto halfSum = a ^ b;
+        sum = halfSum ^ c;
+        carry = (a & b) | (halfSum & c);
+    }
+
+    /** Calculates the next state of one word of cells from the bit-sliced neighbor counts. */
+    inline BoardRow stepWord (
+        BoardRow aboveWest, BoardRow above, BoardRow aboveEast,
+        BoardRow west, BoardRow word, BoardRow east,
+        BoardRow belowWest, BoardRow below, BoardRow belowEast,
+        RuleMaskType birthMask, RuleMaskType survivalMask
+    ) {
+        // Add up the neighbors column-wise...
+        BoardRow aboveSum, aboveCarry, belowSum, belowCarry, rowSum, rowCarry;
+        fullAdd (aboveWest, above, aboveEast, aboveSum, aboveCarry);
+        fullAdd (belowWest, below, belowEast, belowSum, belowCarry);
+        halfAdd (west, east, rowSum, rowCarry);
 
-        for (auto& cell : board) {
-            auto cellLive = rack::random::uniform () < density;
-            cell = (cell & ~AutomataCell::MASK_Live) | (cellLive ? liveFlag : AutomataCell::None);
+        // ...then combine the partial sums into a 4-bit count per cell.
+        BoardRow count0, onesCarry, twosSum, twosCarry, count1, count1Carry;
+        fullAdd (aboveSum, belowSum, rowSum, count0, onesCarry);
+        fullAdd (aboveCarry, belowCarry, rowCarry, twosSum, twosCarry);
+        halfAdd (twosSum, onesCarry, count1, count1Carry);
+        auto count2 = twosCarry ^ count1Carry;
+        auto count3 = twosCarry & count1Carry;
+
+        BoardRow newWord = 0;
+        for (int n = 0; n < NeighborsCount; n++) {
+            auto ruleCells = (((birthMask >> n) & 1) ? ~word : 0) | (((survivalMask >> n) & 1) ? word : 0);
+            if (ruleCells == 0)
+                continue;
+
+            auto countMatches = ((n & 1) ? count0 : ~count0)
+                              & ((n & 2) ? count1 : ~count1)
+                              & ((n & 4) ? count2 : ~count2)
+                              & ((n & 8) ? count3 : ~count3);
+            newWord |= countMatches & ruleCells;
         }
 
-        markUpdated ();
+        return newWord;
     }
 
-    int checkNeighbor (const AutomataBoard& board, const AutomataCell liveFlag, int x, int y) {
-        return testCellFlag (board.at ((x + BoardWidth) % BoardWidth, (y + BoardHeight) % BoardHeight), liveFlag);
+    /** Shifts a row's cells one column east, so each bit holds its western neighbor. Wraps around the row. */
+    inline BoardRow shiftWest (const BoardRow* row, int wordI, int rowWords) {
+        auto prevWord = row [(wordI + rowWords - 1) % rowWords];
+        return (row [wordI] << 1) | (prevWord >> (BoardWordBits - 1));
     }
 
-    int countNeighbors (const AutomataBoard& board, const AutomataCell liveFlag, int x, int y) {
-        return checkNeighbor (board, liveFlag, x + -1, y + -1)
-             + checkNeighbor (board, liveFlag, x + -1, y +  0)
-             + checkNeighbor (board, liveFlag, x + -1, y +  1)
-             + checkNeighbor (board, liveFlag, x +  0, y + -1)
-             + checkNeighbor (board, liveFlag, x +  0, y +  1)
-             + checkNeighbor (board, liveFlag, x +  1, y + -1)
-             + checkNeighbor (board, liveFlag, x +  1, y +  0)
-             + checkNeighbor (board, liveFlag, x +  1, y +  1);
+    /** Shifts a row's cells one column west, so each bit holds its eastern neighbor. Wraps around the row. */
+    inline BoardRow shiftEast (const BoardRow* row, int wordI, int rowWords) {
+        auto nextWord = row [(wordI + 1) % rowWords];
+        return (row [wordI] >> 1) | (nextWord << (BoardWordBits - 1));
     }
 
-    void AutomataLife::process () {
-        board.flipBoard ();
-        auto liveFlag = board.getLiveFlag ();
-        auto liveFlagPrev = board.getLiveFlagPrev ();
+    /*
+     * Larger than Life
+     */
+    /** Adds or removes a row's cells to the running column sums. */
+    inline void addColumnSums (const BoardRow* row, int width, uint16_t* columnSums, int sign) {
+        for (int x = 0; x < width; x++)
+            columnSums [x] += sign * ((row [x / BoardWordBits] >> (x % BoardWordBits)) & 1);
+    }
+
+    /**
+     * Counts each cell's neighborhood with sliding sums, so the cost doesn't grow with the radius: the column sums
+     * hold the cells within the radius of the current row, and a window over them slides along the row.
+     */
+    void stepLargerThanLife (
+        const AutomataBitplane& source, AutomataBitplane& destination,
+        const AutomataRules& rules, const AutomataBitplane* refractory
+    ) {
+        auto width = source.getWidth ();
+        auto height = source.getHeight ();
+        // The neighborhood can't wrap around onto itself.
+        auto radius = std::min ({ rules.getRadius (), (width - 1) / 2, (height - 1) / 2 });
+        auto ownCount = rules.getCountCenter () ? 0 : 1;
+        auto birthMin = rules.getBirthMin (), birthMax = rules.getBirthMax ();
+        auto survivalMin = rules.getSurvivalMin (), survivalMax = rules.getSurvivalMax ();
+
+        std::array<uint16_t, MaxBoardWidth> columnSums;
+        std::fill_n (columnSums.begin (), width, 0);
+        for (int dy = -radius; dy <= radius; dy++)
+            addColumnSums (source.getRow ((dy + height) % height), width, columnSums.data (), 1);
+
+        for (int y = 0; y < height; y++) {
+            auto row = source.getRow (y);
+            auto refractoryRow = refractory != nullptr ? refractory->getRow (y) : nullptr;
+            auto newRow = destination.getRow (y);
+
+            int windowSum = 0;
+            for (int dx = -radius; dx <= radius; dx++)
+                windowSum += columnSums [(dx + width) % width];
+
+            for (int wordI = 0; wordI < source.getRowWords (); wordI++) {
+                auto word = row [wordI];
+                BoardRow newWord = 0;
+                for (int bitI = 0; bitI < BoardWordBits; bitI++) {
+                    auto x = wordI * BoardWordBits + bitI;
+                    auto alive = (word >> bitI) & 1;
+                    auto count = windowSum - (alive ? ownCount : 0);
 
+                    auto newAlive = alive ? (count >= survivalMin && count <= survivalMax)
+                                          : (count >= birthMin && count <= birthMax);
+                    newWord |= BoardRow (newAlive) << bitI;
+
+                    windowSum += columnSums [(x + radius + 1) % width] - columnSums [(x - radius + width) % width];
+                }
+
+                newRow [wordI] = newWord & ~(refractoryRow != nullptr ? refractoryRow [wordI] : 0);
+            }
+
+            // Move the column sums down to the next row.
+            addColumnSums (source.getRow ((y + radius + 1) % height), width, columnSums.data (), 1);
+            addColumnSums (source.getRow ((y - radius + height) % height), width, columnSums.data (), -1);
+        }
+    }
+
+    void stepLife (
+        const AutomataBitplane& source, AutomataBitplane& destination,
+        const AutomataRules& rules, const AutomataBitplane* refractory
+    ) {
+        assert (source.getWidth () == destination.getWidth () && source.getHeight () == destination.getHeight ());
+        assert (refractory == nullptr || (refractory->getWidth () == source.getWidth () && refractory->getHeight () == source.getHeight ()));
+
+        if (rules.isLargerThanLife ())
+            return stepLargerThanLife (source, destination, rules, refractory);
+
+        auto height = source.getHeight ();
+        auto rowWords = source.getRowWords ();
         auto birthMask = rules.getBirthMask ();
         auto survivalMask = rules.getSurvivalMask ();
-        for (int x = 0; x < BoardWidth; x++) {
-            for (int y = 0; y < BoardHeight; y++) {
-                auto& curCell = board.at (x, y);
-                auto neighbors = countNeighbors (board, liveFlagPrev, x, y);
-                auto wasAlive = testCellFlag (curCell, liveFlagPrev);
-
-                auto ruleFormat = 1 << neighbors;
-                auto isAlive = ( wasAlive && (ruleFormat & survivalMask) != 0) ||
-                               (!wasAlive && (ruleFormat & birthMask   ) != 0);
-                curCell = (curCell & ~liveFlag) | (isAlive ? liveFlag : AutomataCell::None);
+        for (int y = 0; y < height; y++) {
+            auto above = source.getRow ((y + height - 1) % height);
+            auto row = source.getRow (y);
+            auto below = source.getRow ((y + 1) % height);
+            auto newRow = destination.getRow (y);
+            auto refractoryRow = refractory != nullptr ? refractory->getRow (y) : nullptr;
+
+            for (int wordI = 0; wordI < rowWords; wordI++) {
+                newRow [wordI] = stepWord (
+                    shiftWest (above, wordI, rowWords), above [wordI], shiftEast (above, wordI, rowWords),
+                    shiftWest (row  , wordI, rowWords), row   [wordI], shiftEast (row  , wordI, rowWords),
+                    shiftWest (below, wordI, rowWords), below [wordI], shiftEast (below, wordI, rowWords),
+                    birthMask, survivalMask
+                );
+                if (refractoryRow != nullptr)
+                    newRow [wordI] &= ~refractoryRow [wordI];
             }
         }
+    }
 
-        markUpdated ();
+    void AutomataLife::setRewindLength (int length) {
+        rewindBuffer.setLength (length);
+        rewindPosition = 0;
+        rewindBuffer.push (board.getLivePlane ());
+    }
+
+    void AutomataLife::loadRewound (int age) {
+        rewindPosition = age;
+        rewindBuffer.get (age, board.getLivePlane ());
+        if (age + 1 < rewindBuffer.getCount ())
+            rewindBuffer.get (age + 1, board.getLivePlanePrev ());
+        else
+            board.getLivePlanePrev ().clear ();
+
+        // The decaying cells only depend on the generations before this one.
+        decay.clear ();
+        const auto& livePlane = board.getLivePlane ();
+        auto decayAges = std::min (rules.getStates () - 2, rewindBuffer.getCount () - age - 1);
+        for (int olderAge = age + decayAges; olderAge > age; olderAge--) {
+            decay.push (
+                rewindBuffer.getWords (olderAge), rewindBuffer.getWords (olderAge - 1),
+                livePlane.getRowWords (), livePlane.getHeight ()
+            );
+        }
+    }
+
+    void AutomataLife::rewind (int age) {
+        age = std::clamp (age, 0, std::max (rewindBuffer.getCount () - 1, 0));
+        if (age == rewindPosition || rewindBuffer.getCount () < 1)
+            return;
+
+        loadRewound (age);
+        // Jumping around breaks the chain of generations the cycle history relies on.
+        restartHistory ();
+
+        markStepped ();
+    }
+
+    void AutomataLife::process () {
+        if (rewindPosition > 0) {
+            loadRewound (rewindPosition - 1);
+            history.push (board.getLivePlane ());
+
+            return markStepped ();
+        }
+
+        board.flipBoard ();
+        if (canReplayCycle ())
+            history.getCycleNext (board.getLivePlane ());
+        else
+            stepLife (board.getLivePlanePrev (), board.getLivePlane (), rules, decay.getRefractory (rules));
+        decay.push (board.getLivePlanePrev (), board.getLivePlane ());
+        history.push (board.getLivePlane ());
+        rewindBuffer.push (board.getLivePlane ());
+
+        markStepped ();
+    }
+
+    void AutomataLife::process (const AutomataBitplane& nextGeneration) {
+        assert (rewindPosition == 0);
+
+        board.flipBoard ();
+        board.getLivePlane () = nextGeneration;
+        decay.push (board.getLivePlanePrev (), board.getLivePlane ());
+        history.push (board.getLivePlane ());
+        rewindBuffer.push (board.getLivePlane ());
+
+        markStepped ();
     }
 
     json_t* AutomataLife::dataToJson () const {
@@ -143,8 +509,50 @@ namespace OuroborosModules::Modules::Automata {
         json_object_try_get_struct (rootJ, "rules", rules);
         json_object_try_get_struct (rootJ, "board", board);
 
+        // The rewind buffer holds the generations before the load.
+        rewindBuffer.clear ();
+        rewindPosition = 0;
         markUpdated ();
 
         return true;
     }
+
+    /*
+     * AutomataVoice
+     */
+    void AutomataVoice::reset (const AutomataBoard& board) {
+        livePlanes [boardFlip] = board.getPlane (AutomataCell::FLAG_SeedSet);
+        livePlanes [!boardFlip] = livePlanes [boardFlip];
+        livePlanes [!boardFlip].clear ();
+
+        decay.clear ();
+        restartHistory ();
+    }
+
+    void AutomataVoice::randomize (const AutomataBoard& board, float density, AutomataRandom& rng) {
+        for (auto& plane : livePlanes)
+            plane.resize (board.getWidth (), board.getHeight ());
+
+        randomizePlane (livePlanes [boardFlip], density, rng);
+        livePlanes [!boardFlip].clear ();
+
+        decay.clear ();
+        restartHistory ();
+    }
+
+    void AutomataVoice::process (const AutomataRules& newRules) {
+        // Generations replayed from the history would follow the old rules.
+        if (newRules != rules) {
+            rules = newRules;
+            restartHistory ();
+        }
+
+        boardFlip = !boardFlip;
+        if (canReplayCycle ())
+            history.getCycleNext (livePlanes [boardFlip]);
+        else
+            stepLife (livePlanes [!boardFlip], livePlanes [boardFlip], rules, decay.getRefractory (rules));
+        decay.push (livePlanes [!boardFlip], livePlanes [boardFlip]);
+        history.push (livePlanes [boardFlip]);
+    }
 }
\ No newline at end of file
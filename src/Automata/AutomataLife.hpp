@@ -18,49 +18,286 @@
 
 #pragma once
 
+#include "../DSP/Random.hpp"
 #include "../PluginDef.hpp"
 
 #include "AutomataCommon.hpp"
 
+#include <algorithm>
 #include <array>
+#include <limits>
+#include <vector>
 
 namespace OuroborosModules::Modules::Automata {
+    using BoardRow = uint32_t;
+    static_assert (BoardWordBits == std::numeric_limits<BoardRow>::digits, "BoardWordBits must match the row word type");
+
+    /**
+     * One bit per cell, packed into words of 32 cells. Bit n of word w in a row is the cell in column w * 32 + n.
+     * The storage covers the largest board, but only the words in use are copied.
+     */
+    struct AutomataBitplane {
+      private:
+        std::array<BoardRow, MaxBoardWords> words;
+        int rowWords = DefaultBoardWidth / BoardWordBits;
+        int height = DefaultBoardHeight;
+
+      public:
+        AutomataBitplane () { words.fill (0); }
+        AutomataBitplane (const AutomataBitplane& other) { *this = other; }
+        AutomataBitplane& operator= (const AutomataBitplane& other) {
+            rowWords = other.rowWords;
+            height = other.height;
+            std::copy_n (other.words.begin (), getWordCount (), words.begin ());
+            return *this;
+        }
+
+        int getWidth () const { return rowWords * BoardWordBits; }
+        int getHeight () const { return height; }
+        int getRowWords () const { return rowWords; }
+        int getWordCount () const { return rowWords * height; }
+
+        BoardRow* getRow (int y) { return &words [y * rowWords]; }
+        const BoardRow* getRow (int y) const { return &words [y * rowWords]; }
+        BoardRow* data () { return words.data (); }
+        const BoardRow* data () const { return words.data (); }
+
+        bool get (int x, int y) const { return (getRow (y) [x / BoardWordBits] >> (x % BoardWordBits)) & 1; }
+        void set (int x, int y, bool value) {
+            auto& word = getRow (y) [x / BoardWordBits];
+            auto bit = BoardRow (1) << (x % BoardWordBits);
+            word = (word & ~bit) | (value ? bit : 0);
+        }
+
+        void clear () { std::fill_n (words.begin (), getWordCount (), 0); }
+        /** Changes the size of the plane, keeping the cells that are inside both sizes. */
+        void resize (int newWidth, int newHeight);
+
+        /** FNV-1a over the words in use. Equal planes hash equally, but compare them to rule out collisions. */
+        uint64_t hash () const;
+        bool operator== (const AutomataBitplane& rhs) const {
+            return rowWords == rhs.rowWords && height == rhs.height &&
+                   std::equal (words.begin (), words.begin () + getWordCount (), rhs.words.begin ());
+        }
+        bool operator!= (const AutomataBitplane& rhs) const { return !(*this == rhs); }
+    };
+
     struct AutomataBoard {
+        /** The live A/B flags, the seed flag and one plane per trigger set. */
+        static constexpr int PlaneCount = 3 + TriggerCount;
+
       private:
-        std::array<AutomataCell, BoardWidth * BoardHeight> boardData;
+        std::array<AutomataBitplane, PlaneCount> planes;
         bool boardFlip;
 
+        static int planeFromFlag (AutomataCell flag);
+        bool dataFromJson_Legacy (json_t* rootJ, int width, int height);
+
       public:
         AutomataBoard ();
 
-        const AutomataCell& at (std::size_t x, std::size_t y) const { return boardData [y * BoardWidth + x]; }
-        AutomataCell& at (std::size_t x, std::size_t y) { return boardData [y * BoardWidth + x]; }
+        int getWidth () const { return planes [0].getWidth (); }
+        int getHeight () const { return planes [0].getHeight (); }
+        bool isInside (int x, int y) const { return x >= 0 && y >= 0 && x < getWidth () && y < getHeight (); }
+        static bool isValidSize (int width, int height) {
+            return width >= BoardWordBits && width <= MaxBoardWidth && (width % BoardWordBits) == 0 &&
+                   height >= MinBoardHeight && height <= MaxBoardHeight;
+        }
+        void resize (int width, int height);
+
+        /** Gathers the flags of a single cell. Prefer working on whole planes where possible. */
+        AutomataCell at (int x, int y) const;
+        void set (int x, int y, AutomataCell cell);
 
-        auto begin () { return boardData.begin (); }
-        auto end () { return boardData.end (); }
-        auto begin () const { return boardData.begin (); }
-        auto end () const { return boardData.end (); }
+        /** Gets the plane holding a single-bit flag. */
+        AutomataBitplane& getPlane (AutomataCell flag) { return planes [planeFromFlag (flag)]; }
+        const AutomataBitplane& getPlane (AutomataCell flag) const { return planes [planeFromFlag (flag)]; }
+
+        AutomataBitplane& getLivePlane () { return getPlane (getLiveFlag ()); }
+        const AutomataBitplane& getLivePlane () const { return getPlane (getLiveFlag ()); }
+        AutomataBitplane& getLivePlanePrev () { return getPlane (getLiveFlagPrev ()); }
+        const AutomataBitplane& getLivePlanePrev () const { return getPlane (getLiveFlagPrev ()); }
 
         void flipBoard () { boardFlip = !boardFlip; }
         AutomataCell getLiveFlag     () const { return boardFlip ? AutomataCell::FLAG_LiveB : AutomataCell::FLAG_LiveA; }
         AutomataCell getLiveFlagPrev () const { return boardFlip ? AutomataCell::FLAG_LiveA : AutomataCell::FLAG_LiveB; }
 
-        void clear () { boardData.fill (AutomataCell::None); }
+        void clear () {
+            for (auto& plane : planes)
+                plane.clear ();
+        }
 
         json_t* dataToJson () const;
         bool dataFromJson (json_t* rootJ);
     };
 
+    using AutomataRandom = DSP::Xoshiro128PlusBatch<8>;
+
+    /**
+     * Calculates the generation after source into destination. Both planes must be the same size.
+     * Refractory cells, if given, can't be born. See AutomataDecay.
+     */
+    void stepLife (
+        const AutomataBitplane& source, AutomataBitplane& destination,
+        const AutomataRules& rules, const AutomataBitplane* refractory = nullptr
+    );
+    /** Sets each cell of the plane to live with the given probability. */
+    void randomizePlane (AutomataBitplane& plane, float density, AutomataRandom& rng);
+
+    /**
+     * A ring of the hashes of the most recent generations, used to find the board repeating itself.
+     * Once it does, one period of generations is recorded, packed down to the words in use, so the cycle can be
+     * replayed instead of calculated. Periods too long for the frame budget are still detected, just not replayed.
+     */
+    struct AutomataHistory {
+        static constexpr int Length = 64;
+        /** Fits every period on the default board size, and still lifes on the largest one. */
+        static constexpr int FrameWordBudget = MaxBoardWords;
+
+      private:
+        std::array<uint64_t, Length> hashes;
+        int head = 0;
+        int count = 0;
+        int cycleLength = 0;
+        int cycleRepeats = 0;
+
+        // The generations of the current cycle. The cursor points at the oldest one, which is also the next to come.
+        std::vector<BoardRow> frames;
+        int frameWords = 0;
+        int frameCount = 0;
+        int frameCursor = 0;
+        bool framesVerified = false;
+
+        int indexFromAge (int age) const { return (head + Length - age) % Length; }
+        void restartFrames () {
+            frameCount = 0;
+            frameCursor = 0;
+            framesVerified = false;
+        }
+        void recordFrame (const AutomataBitplane& generation);
+
+      public:
+        AutomataHistory () : frames (FrameWordBudget) { }
+
+        void clear () {
+            count = 0;
+            cycleLength = 0;
+            cycleRepeats = 0;
+            restartFrames ();
+        }
+        bool empty () const { return count < 1; }
+        /** Records a new current generation and checks whether it repeats a remembered one. */
+        void push (const AutomataBitplane& generation);
+
+        /** The period of the cycle the board is in, or 0 if no repetition was found. */
+        int getCycleLength () const { return cycleLength; }
+        /** How many generations in a row repeated with the current period. */
+        int getCycleRepeats () const { return cycleRepeats; }
+        /** Whether a whole period was recorded and seen repeating, so the following generations can be replayed. */
+        bool canReplay () const { return framesVerified; }
+        /** Copies the generation after the current one into a plane of the same size. Must only be called if the cycle can be replayed. */
+        void getCycleNext (AutomataBitplane& destination) const;
+    };
+
+    /**
+     * The cells of Generations rules that died recently and can't be born yet. A cell decays for one generation
+     * per extra state, so this only needs how many generations ago each cell last died. The ages are bit-sliced,
+     * one plane per bit, so a word of cells is aged at a time.
+     */
+    struct AutomataDecay {
+        static constexpr int AgeBits = 4;
+        /** Cells that didn't die since the decay was cleared stay at this age. */
+        static constexpr int MaxAge = (1 << AgeBits) - 1;
+        static_assert (MaxAge >= MaxRuleStates - 2, "AgeBits must fit the longest decay");
+
+      private:
+        std::array<AutomataBitplane, AgeBits> agePlanes;
+        AutomataBitplane refractory;
+        int rowWords = 0;
+        int height = 0;
+        bool empty = true;
+
+      public:
+        void clear () { empty = true; }
+        /** Records the cells that died between two consecutive generations, given as packed words. */
+        void push (const BoardRow* previous, const BoardRow* current, int rowWords, int height);
+        void push (const AutomataBitplane& previous, const AutomataBitplane& current) {
+            push (previous.data (), current.data (), current.getRowWords (), current.getHeight ());
+        }
+        /** The cells that can't be born in the next generation, or null if the rules don't decay. */
+        const AutomataBitplane* getRefractory (const AutomataRules& rules);
+    };
+
+    /**
+     * The most recent generations, packed down to the words in use, so the board can be stepped backwards.
+     * The storage is allocated once and fits MaxRewindLength generations of the default board size;
+     * larger boards fit proportionally fewer. Generations are addressed by age, where age 0 is the newest one.
+     */
+    struct AutomataRewindBuffer {
+        static constexpr int WordBudget = MaxRewindLength * (DefaultBoardWidth / BoardWordBits) * DefaultBoardHeight;
+
+      private:
+        std::vector<BoardRow> words;
+        int rowWords = 0;
+        int height = 0;
+        int length = DefaultRewindLength;
+        int capacity = 0;
+        int head = 0;
+        int count = 0;
+
+        int indexFromAge (int age) const { return (head + capacity - age) % capacity; }
+        const BoardRow* getGeneration (int age) const { return &words [indexFromAge (age) * rowWords * height]; }
+
+      public:
+        AutomataRewindBuffer () : words (WordBudget) { }
+
+        /** Forgets all generations. */
+        void setLength (int newLength) {
+            length = std::clamp (newLength, 1, MaxRewindLength);
+            clear ();
+        }
+        int getLength () const { return length; }
+        /** How many generations of the current size fit. */
+        int getCapacity () const { return capacity; }
+        int getCount () const { return count; }
+
+        void clear () {
+            head = 0;
+            count = 0;
+        }
+        /** Records a new newest generation. A generation of a different size forgets the others. */
+        void push (const AutomataBitplane& generation);
+        /** Forgets the given number of newest generations. */
+        void dropNewest (int dropCount);
+        bool isNewest (const AutomataBitplane& generation) const;
+        const BoardRow* getWords (int age) const { return getGeneration (age); }
+        /** Copies a remembered generation into a plane of the same size. */
+        void get (int age, AutomataBitplane& destination) const;
+    };
+
     struct AutomataLife {
       private:
         bool updated;
-        std::atomic<AutomataLifeUpdateIndex> updateIdx = 1;
+        /** Incremented on every change to the board or rules, to tell stale precomputed generations apart. */
+        uint64_t version = 0;
 
         // Rule data
         AutomataRules rules;
 
         // Board data
         AutomataBoard board;
+        AutomataHistory history;
+        AutomataRewindBuffer rewindBuffer;
+        /** How far back the board was rewound. Stepping forward replays the rewound generations first. */
+        int rewindPosition = 0;
+        AutomataDecay decay;
+
+        void markStepped ();
+        void restartHistory () {
+            history.clear ();
+            history.push (board.getLivePlane ());
+        }
+        void loadRewound (int age);
 
       public:
         AutomataLife ();
@@ -68,21 +305,89 @@ namespace OuroborosModules::Modules::Automata {
         AutomataBoard& getBoard () { return board; }
         const AutomataBoard& getBoard () const { return board; }
 
-        /** Must be called when the board is modified. */
+        /**
+         * Must be called when the board is modified. Forgets the cycle history, since edits break the chain of generations,
+         * and records the modified board as the newest generation to rewind from.
+         */
         void markUpdated ();
+        /** Clears the updated flag. Returns true if the board was modified since the last call. */
         bool handleUpdated ();
-        AutomataLifeUpdateIndex getUpdateIndex () const { return updateIdx.load (); }
-        bool checkUpdated (AutomataLifeUpdateIndex& lastindex);
+        uint64_t getVersion () const { return version; }
 
         void initialize ();
         void reset ();
-        void randomize (float density);
-        AutomataRules getRules () { return rules; }
-        void setRules (AutomataRules newRules) { rules = newRules; }
+        void randomize (float density, AutomataRandom& rng);
+        AutomataRules getRules () const { return rules; }
+        void setRules (AutomataRules newRules) {
+            rules = newRules;
+            // Generations replayed from the history would follow the old rules.
+            restartHistory ();
+            version++;
+        }
+
+        /** Generations rules only cycle once the decaying cells repeat too, which takes a repeat per extra state. */
+        int getCycleLength () const { return history.getCycleRepeats () >= rules.getStates () - 1 ? history.getCycleLength () : 0; }
+        bool isCycling () const { return getCycleLength () > 0; }
+        bool canReplayCycle () const { return isCycling () && history.canReplay (); }
+        /** Whether the next generation only depends on the live cells, so it can be calculated ahead of time with stepLife. */
+        bool canStepAhead () const { return !canReplayCycle () && !isRewound () && !rules.isGenerations (); }
 
+        int getRewindLength () const { return rewindBuffer.getLength (); }
+        /** Forgets the generations to rewind to. */
+        void setRewindLength (int length);
+        /** How many generations are remembered, the newest one included. */
+        int getRewindCount () const { return rewindBuffer.getCount (); }
+        int getRewindPosition () const { return rewindPosition; }
+        bool isRewound () const { return rewindPosition > 0; }
+        /** Goes back to the generation of the given age, counted from the newest one. Newer generations are kept to step forward through. */
+        void rewind (int age);
+
+        /**
+         * Advances to the next generation. When rewound, it's replayed from the rewind buffer, and inside a cycle
+         * from the history, instead of calculated.
+         */
         void process ();
+        /** Advances to a generation calculated ahead of time with stepLife. Must not be used when rewound. */
+        void process (const AutomataBitplane& nextGeneration);
 
         json_t* dataToJson () const;
         bool dataFromJson (json_t* rootJ);
     };
+
+    /**
+     * The live cells of an extra polyphony channel. It starts from the main board's seed and
+     * evolves on its own, following the main board's rules, trigger sets and size.
+     */
+    struct AutomataVoice {
+      private:
+        std::array<AutomataBitplane, 2> livePlanes;
+        bool boardFlip = false;
+        AutomataRules rules;
+        AutomataHistory history;
+        AutomataDecay decay;
+
+        void restartHistory () {
+            history.clear ();
+            history.push (getLivePlane ());
+        }
+
+      public:
+        const AutomataBitplane& getLivePlane () const { return livePlanes [boardFlip]; }
+        const AutomataBitplane& getLivePlanePrev () const { return livePlanes [!boardFlip]; }
+
+        /** Whether the voice can be played against the board. If not, it has to be reset to it first. */
+        bool matchesBoard (const AutomataBoard& board) const {
+            return getLivePlane ().getWidth () == board.getWidth () && getLivePlane ().getHeight () == board.getHeight ();
+        }
+
+        void reset (const AutomataBoard& board);
+        void randomize (const AutomataBoard& board, float density, AutomataRandom& rng);
+
+        int getCycleLength () const { return history.getCycleRepeats () >= rules.getStates () - 1 ? history.getCycleLength () : 0; }
+        bool isCycling () const { return getCycleLength () > 0; }
+        bool canReplayCycle () const { return isCycling () && history.canReplay (); }
+
+        /** Advances to the next generation. A change of rules forgets the history. */
+        void process (const AutomataRules& newRules);
+    };
 }
\ No newline at end of file
@@ -24,25 +24,47 @@
 
 namespace OuroborosModules::Modules::Automata {
     struct BoardCoords {
+        /** Cells smaller than this are drawn without spacing. */
+        static constexpr float MinSpacedCellSize = 4.f;
+
         rack::math::Vec gridSize;
         rack::math::Vec cellCounts;
-        rack::math::Vec spacingLosses;
+        rack::math::Vec cellPitch;
         rack::math::Vec cellSize;
+        rack::math::Vec viewOffset;
 
         BoardCoords (AutomataBoardWidget* boardWidget, float footerSize) {
             gridSize = boardWidget->box.size;
             gridSize.x -= BoardMargin * 2;
             gridSize.y -= BoardMargin * 2 + 4 + footerSize;
 
-            cellCounts = rack::math::Vec (BoardWidth, BoardHeight);
-            spacingLosses = BoardSpacing * cellCounts.minus (1);
-            cellSize = gridSize.minus (spacingLosses).div (cellCounts);
+            const auto& board = boardWidget->getBoard ();
+            auto zoom = boardWidget->getViewZoom ();
+            cellCounts = rack::math::Vec (board.getWidth (), board.getHeight ());
+            viewOffset = boardWidget->getViewOffset ();
+
+            auto unspacedPitch = gridSize.div (cellCounts).mult (zoom);
+            auto spacing = std::min (unspacedPitch.x, unspacedPitch.y) >= MinSpacedCellSize ? BoardSpacing : 0.f;
+            cellPitch = gridSize.plus (spacing).div (cellCounts).mult (zoom);
+            cellSize = cellPitch.minus (spacing);
         }
 
         rack::math::Vec getCellPos (int x, int y) const {
-            return rack::math::Vec (x * (cellSize.x + BoardSpacing), y * (cellSize.y + BoardSpacing));
+            return rack::math::Vec (x, y).minus (viewOffset).mult (cellPitch);
         }
 
+        /** The range of cells that are at least partially visible. */
+        void getVisibleCells (int& firstX, int& firstY, int& endX, int& endY) const {
+            auto visibleCells = gridSize.div (cellPitch);
+            firstX = std::max (static_cast<int> (viewOffset.x), 0);
+            firstY = std::max (static_cast<int> (viewOffset.y), 0);
+            endX = std::min (static_cast<int> (std::ceil (viewOffset.x + visibleCells.x)), static_cast<int> (cellCounts.x));
+            endY = std::min (static_cast<int> (std::ceil (viewOffset.y + visibleCells.y)), static_cast<int> (cellCounts.y));
+        }
+
+        /** Converts a position relative to the grid into fractional cell coordinates. */
+        rack::math::Vec gridPosToCells (rack::math::Vec pos) const { return pos.div (cellPitch).plus (viewOffset); }
+
         bool posToCell (rack::math::Vec pos, int& x, int& y) const {
             pos = pos.minus (BoardMargin);
 
@@ -52,17 +74,17 @@ namespace OuroborosModules::Modules::Automata {
                 return false;
             }
 
-            auto fullCellSize = cellSize.plus (BoardSpacing);
-            auto col = pos.x / fullCellSize.x;
-            auto row = pos.y / fullCellSize.y;
+            auto cellPos = gridPosToCells (pos);
+            auto col = static_cast<int> (std::floor (cellPos.x));
+            auto row = static_cast<int> (std::floor (cellPos.y));
 
-            if (col >= BoardWidth || row >= BoardHeight) {
+            if (col < 0 || row < 0 || col >= cellCounts.x || row >= cellCounts.y) {
                 x = -1; y = -1;
                 return false;
             }
 
-            auto fullCellX = pos.x - (col * fullCellSize.x);
-            auto fullCellY = pos.y - (row * fullCellSize.y);
+            auto fullCellX = (cellPos.x - col) * cellPitch.x;
+            auto fullCellY = (cellPos.y - row) * cellPitch.y;
 
             if (fullCellX > cellSize.x || fullCellY > cellSize.y) {
                 x = -1; y = -1;
@@ -75,6 +97,15 @@ namespace OuroborosModules::Modules::Automata {
         }
     };
 
+    /** Draws the board's cells into its framebuffer. */
+    struct AutomataBoardCellsWidget : rack::widget::Widget {
+        AutomataBoardWidget* boardWidget;
+
+        AutomataBoardCellsWidget (AutomataBoardWidget* boardWidget) : boardWidget (boardWidget) { }
+
+        void draw (const DrawArgs& args) override { boardWidget->drawCells (args); }
+    };
+
     AutomataBoardWidget::AutomataBoardWidget (rack::math::Vec size, AutomataWidget* panelWidget)
         : editGrid () {
         using rack::math::Vec;
@@ -86,43 +117,57 @@ namespace OuroborosModules::Modules::Automata {
         displayBG->box.size = size;
         addChild (displayBG);
 
+        // Not a child, since it has to be drawn on the display layer.
+        cellsFramebuffer = new rack::widget::FramebufferWidget;
+        cellsWidget = new AutomataBoardCellsWidget (this);
+        cellsFramebuffer->addChild (cellsWidget);
+
         auto module = panelWidget->getAutomata ();
-        if (module != nullptr)
-            module->lifeBoard.checkUpdated (lifeUpdateIndex);
-        else { // Module browser
+        if (module == nullptr) { // Module browser
             // Default rule (Game of Life)
             ruleString = "B3/S23";
 
             // Default seed
             internalBoard.clear ();
-            for (int y = 0; y < BoardHeight; y++) {
-                for (int x = 0; x < BoardWidth; x++) {
-                    if (DefaultBoard_Seed [y] [x] == 1)
-                        internalBoard.at (x, y) = AutomataCell::FLAG_LiveA;
-                }
+            auto& livePlane = internalBoard.getLivePlane ();
+            for (int y = 0; y < DefaultBoardHeight; y++) {
+                for (int x = 0; x < DefaultBoardWidth; x++)
+                    livePlane.set (x, y, DefaultBoard_Seed [y] [x] == 1);
             }
         }
     }
 
+    AutomataBoardWidget::~AutomataBoardWidget () {
+        delete cellsFramebuffer;
+    }
+
     void AutomataBoardWidget::step () {
         _ThemedWidgetBase::step ();
+        cellsFramebuffer->step ();
 
         auto module = panelWidget->getAutomata ();
         if (module == nullptr)
             return;
 
-        auto curRules = module->getLifeBoard ().getRules ();
-        if (lastRules != curRules) {
-            ruleString = curRules.getRuleString ();
-            lastRules = curRules;
-        }
+        // Executed commands are freed here, so the audio thread never has to.
+        module->commandQueue.flush ();
 
-        if (!module->lifeBoard.checkUpdated (lifeUpdateIndex))
+        if (!module->displayTelemetry.update ())
             return;
 
-        internalBoard = module->lifeBoard.getBoard ();
+        const auto& displayData = module->displayTelemetry.read ();
+        if (lastRules != displayData.rules) {
+            lastRules = displayData.rules;
+            ruleString = lastRules.getRuleString ();
+        }
+
+        auto oldWidth = internalBoard.getWidth ();
+        auto oldHeight = internalBoard.getHeight ();
+
+        internalBoard = displayData.board;
+        internalMode = displayData.mode;
         for (auto it = editCommands.begin (); it != editCommands.end ();) {
-            if ((*it)->executed) {
+            if ((*it)->queueIndex < displayData.commandsExecuted) {
                 it = editCommands.erase (it);
                 continue;
             }
@@ -131,6 +176,25 @@ namespace OuroborosModules::Modules::Automata {
 
             ++it;
         }
+
+        if (internalBoard.getWidth () != oldWidth || internalBoard.getHeight () != oldHeight)
+            resetView ();
+        invalidateCells ();
+    }
+
+    void AutomataBoardWidget::resetView () {
+        viewZoom = 1.f;
+        viewOffset = rack::math::Vec ();
+        invalidateCells ();
+    }
+
+    void AutomataBoardWidget::clampView () {
+        viewZoom = canZoom () ? std::clamp (viewZoom, 1.f, MaxViewZoom) : 1.f;
+
+        auto cellCounts = rack::math::Vec (internalBoard.getWidth (), internalBoard.getHeight ());
+        auto maxOffset = cellCounts.minus (cellCounts.div (viewZoom));
+        viewOffset = viewOffset.clamp (rack::math::Rect (rack::math::Vec (), maxOffset));
+        invalidateCells ();
     }
 
     auto getRulesFont () {
@@ -159,89 +223,100 @@ namespace OuroborosModules::Modules::Automata {
         if (panelWidget->getRulesWidget ()->isOpen ())
             return;
 
-        auto module = panelWidget->getAutomata ();
-
         nvgSave (args.vg);
 
         // Rule display
         auto rulesFont = getRulesFont ();
-        nvgFontFaceId (args.vg, getRulesFont ()->handle);
+        nvgFontFaceId (args.vg, rulesFont->handle);
         nvgFontSize (args.vg, 16);
         nvgTextLetterSpacing (args.vg, 0);
         nvgTextLineHeight (args.vg, 1);
 
+        // Larger than Life rule strings can get long, so shrink them to fit.
         std::string_view textStr = ruleString;
+        auto textWidth = nvgTextBounds (args.vg, 0, 0, textStr.begin (), textStr.end (), nullptr);
+        auto maxTextWidth = box.size.x - BoardMargin * 2;
+        if (textWidth > maxTextWidth)
+            nvgFontSize (args.vg, 16 * maxTextWidth / textWidth);
+
         auto ruleStringPos = Vec (BoardMargin, box.size.y - BoardMargin);
         nvgFillColor (args.vg, rack::color::WHITE);
         nvgTextAlign (args.vg, NVG_ALIGN_LEFT | NVG_ALIGN_BOTTOM);
         nvgText (args.vg, VEC_ARGS (ruleStringPos), textStr.begin (), textStr.end ());
+
+        auto footerSize = lastFooterSize;
         nvgTextMetrics (args.vg, nullptr, nullptr, &lastFooterSize);
+        if (lastFooterSize != footerSize)
+            invalidateCells ();
 
         // Board cells
+        auto gridSize = BoardCoords (this, lastFooterSize).gridSize;
+        if (!cellsWidget->box.size.equals (gridSize)) {
+            cellsWidget->box.size = gridSize;
+            cellsFramebuffer->box.size = gridSize;
+            invalidateCells ();
+        }
+
         nvgTranslate (args.vg, BoardMargin, BoardMargin);
 
+        auto cellsArgs = args;
+        cellsArgs.clipBox.pos = args.clipBox.pos.minus (Vec (BoardMargin));
+        cellsFramebuffer->draw (cellsArgs);
+
+        nvgRestore (args.vg);
+    }
+
+    void AutomataBoardWidget::drawCells (const DrawArgs& args) {
         auto gridder = BoardCoords (this, lastFooterSize);
         auto halfCellSize = gridder.cellSize.div (2);
         auto triggerCircleRadius = std::min (halfCellSize.x, halfCellSize.y) * .75f;
 
-        auto modeSelect = module != nullptr ? module->currentMode : AutomataMode::Play;
+        auto modeSelect = internalMode;
         auto editTriggerMode = modeSelect >= AutomataMode::EditTrigger && modeSelect <= AutomataMode::EditTrigger_LAST;
 
-        const auto& board = internalBoard;
-        auto liveFlag = board.getLiveFlag ();
-        auto triggerFlag = modeToCellTrigger (modeSelect);
+        const auto& livePlane = internalBoard.getLivePlane ();
+        const auto& seedPlane = internalBoard.getPlane (AutomataCell::FLAG_SeedSet);
+        const auto* triggerPlane = editTriggerMode ? &internalBoard.getPlane (modeToCellTrigger (modeSelect)) : nullptr;
+
+        auto isEdited = [&] (int x, int y) {
+            return editing && x < editGrid.getWidth () && y < editGrid.getHeight () && editGrid.at (x, y);
+        };
+
+        int firstX, firstY, endX, endY;
+        gridder.getVisibleCells (firstX, firstY, endX, endY);
+
+        // Every color is a single path, drawn over the previous ones.
+        auto fillCells = [&] (NVGcolor color, bool circles, auto isFilled) {
+            nvgBeginPath (args.vg);
+            for (int y = firstY; y < endY; y++) {
+                for (int x = firstX; x < endX; x++) {
+                    if (!isFilled (x, y))
+                        continue;
+
+                    auto cellPos = gridder.getCellPos (x, y);
+                    if (circles)
+                        nvgCircle (args.vg, VEC_ARGS (cellPos.plus (halfCellSize)), triggerCircleRadius);
+                    else
+                        nvgRect (args.vg, VEC_ARGS (cellPos), VEC_ARGS (gridder.cellSize));
+                }
+            }
+            nvgFillColor (args.vg, color);
+            nvgFill (args.vg);
+        };
 
         auto litColor = rack::color::WHITE;
         auto dimColor = nvgRGB (128, 128, 128);
 
-        for (int y = 0; y < BoardHeight; y++) {
-            for (int x = 0; x < BoardWidth; x++) {
-                auto cellPos = gridder.getCellPos (x, y);
-                nvgBeginPath (args.vg);
-                nvgRect (args.vg, VEC_ARGS (cellPos), VEC_ARGS (gridder.cellSize));
-
-                const auto& cell = board.at (x, y);
-
-                // Get color
-                auto cellLit = false;
-                auto cellDim = false;
-                auto hasTrigger = false;
-                if (modeSelect == AutomataMode::Play)
-                    cellLit = testCellFlag (cell, liveFlag);
-                else if (modeSelect == AutomataMode::EditSeed) {
-                    cellDim = testCellFlag (cell, liveFlag);
-                    cellLit = testCellFlag (cell, AutomataCell::FLAG_SeedSet);
-                    if (editing && editGrid.at (x, y))
-                        cellLit = editSet;
-                } else if (editTriggerMode) {
-                    cellDim = testCellFlag (cell, liveFlag);
-                    hasTrigger = testCellFlag (cell, triggerFlag);
-                    if (editing && editGrid.at (x, y))
-                        hasTrigger = editSet;
-                }
-
-                auto color = nvgRGB (64, 64, 64);
-                if (cellLit)
-                    color = litColor;
-                else if (cellDim)
-                    color = dimColor;
-
-                nvgFillColor (args.vg, color);
-                nvgFill (args.vg);
-
-                if (hasTrigger) {
-                    auto circlePos = cellPos.plus (halfCellSize);
-
-                    nvgBeginPath (args.vg);
-                    nvgCircle (args.vg, VEC_ARGS (circlePos), triggerCircleRadius);
-
-                    nvgFillColor (args.vg, litColor);
-                    nvgFill (args.vg);
-                }
-            }
+        fillCells (nvgRGB (64, 64, 64), false, [] (int x, int y) { return true; });
+        if (modeSelect == AutomataMode::Play)
+            fillCells (litColor, false, [&] (int x, int y) { return livePlane.get (x, y); });
+        else if (modeSelect == AutomataMode::EditSeed) {
+            fillCells (dimColor, false, [&] (int x, int y) { return livePlane.get (x, y); });
+            fillCells (litColor, false, [&] (int x, int y) { return isEdited (x, y) ? editSet : seedPlane.get (x, y); });
+        } else if (editTriggerMode) {
+            fillCells (dimColor, false, [&] (int x, int y) { return livePlane.get (x, y); });
+            fillCells (litColor, true, [&] (int x, int y) { return isEdited (x, y) ? editSet : triggerPlane->get (x, y); });
         }
-
-        nvgRestore (args.vg);
     }
 
     void AutomataBoardWidget::enterEditMode (AutomataCell mask, int cellX, int cellY, bool set) {
@@ -251,20 +326,24 @@ namespace OuroborosModules::Modules::Automata {
 
         editSet = set;
         editMask = mask;
-        editGrid.clear ();
+        editGrid = EditGrid (internalBoard.getWidth (), internalBoard.getHeight ());
 
-        if (cellX >= 0 && cellY >= 0)
-            editGrid.at (cellX, cellY) = true;
+        if (internalBoard.isInside (cellX, cellY))
+            editGrid.set (cellX, cellY, true);
 
         editing = true;
+        invalidateCells ();
     }
     void AutomataBoardWidget::editModeMouseMoved (int cellX, int cellY) {
         assert (editing);
 
-        if (!editing || cellX < 0 || cellY < 0)
+        if (!editing || cellX < 0 || cellY < 0 || cellX >= editGrid.getWidth () || cellY >= editGrid.getHeight ())
+            return;
+        if (editGrid.at (cellX, cellY))
             return;
 
-        editGrid.at (cellX, cellY) = true;
+        editGrid.set (cellX, cellY, true);
+        invalidateCells ();
     }
     void AutomataBoardWidget::exitEditMode () {
         assert (editing);
@@ -273,11 +352,12 @@ namespace OuroborosModules::Modules::Automata {
         if (!editing || module == nullptr)
             return;
 
-        auto cmd = module->addEditCommand<EditCommand_Toggle> (module->lifeBoard.getBoard (), editMask, editGrid, editSet);
+        auto cmd = module->addEditCommand<EditCommand_Toggle> (internalBoard, editMask, editGrid, editSet);
         cmd->execute (internalBoard);
         editCommands.push_back (cmd);
 
         editing = false;
+        invalidateCells ();
     }
 
     void AutomataBoardWidget::onButton (const rack::event::Button& e) {
@@ -286,6 +366,14 @@ namespace OuroborosModules::Modules::Automata {
         if (e.isConsumed () || panelWidget->getRulesWidget ()->isOpen ())
             return;
 
+        // Drag the view around with the middle mouse button, or the left one in play mode.
+        auto panButton = e.button == GLFW_MOUSE_BUTTON_MIDDLE || (e.button == GLFW_MOUSE_BUTTON_LEFT && internalMode == AutomataMode::Play);
+        if (panButton && e.action == GLFW_PRESS && !editing && viewZoom > 1.f) {
+            panning = true;
+            e.consume (this);
+            return;
+        }
+
         // Only allow the left mouse button with no modifier keys held.
         if (e.button != GLFW_MOUSE_BUTTON_LEFT || (e.mods & RACK_MOD_MASK) != 0)
             return;
@@ -297,8 +385,7 @@ namespace OuroborosModules::Modules::Automata {
         } else if (e.action != GLFW_PRESS || editing)
             return;
 
-        auto module = panelWidget->getAutomata ();
-        auto modeSelect = module->currentMode;
+        auto modeSelect = internalMode;
         if (modeSelect == AutomataMode::Play) {
             e.consume (this);
             return;
@@ -317,7 +404,7 @@ namespace OuroborosModules::Modules::Automata {
         if (!gridder.posToCell (e.pos, cellX, cellY))
             return;
 
-        auto curSet = testCellFlag (module->lifeBoard.getBoard ().at (cellX, cellY), cellMask);
+        auto curSet = testCellFlag (internalBoard.at (cellX, cellY), cellMask);
         enterEditMode (cellMask, cellX, cellY, !curSet);
         e.consume (this);
     }
@@ -337,9 +424,27 @@ namespace OuroborosModules::Modules::Automata {
         }
     }
 
+    void AutomataBoardWidget::onDragMove (const rack::event::DragMove& e) {
+        _ThemedWidgetBase::onDragMove (e);
+
+        if (!panning)
+            return;
+
+        auto gridder = BoardCoords (this, lastFooterSize);
+        viewOffset = viewOffset.minus (e.mouseDelta.div (getAbsoluteZoom ()).div (gridder.cellPitch));
+        clampView ();
+        e.consume (this);
+    }
+
     void AutomataBoardWidget::onDragEnd (const rack::event::DragEnd& e) {
         _ThemedWidgetBase::onDragEnd (e);
 
+        if (panning) {
+            panning = false;
+            e.consume (this);
+            return;
+        }
+
         if (e.isConsumed () || panelWidget->getRulesWidget ()->isOpen ())
             return;
 
@@ -349,4 +454,27 @@ namespace OuroborosModules::Modules::Automata {
             e.consume (this);
         }
     }
+
+    void AutomataBoardWidget::onHoverScroll (const rack::event::HoverScroll& e) {
+        _ThemedWidgetBase::onHoverScroll (e);
+
+        if (e.isConsumed () || panelWidget->getRulesWidget ()->isOpen () || !canZoom ())
+            return;
+
+        auto gridder = BoardCoords (this, lastFooterSize);
+        auto gridPos = e.pos.minus (BoardMargin);
+        if (gridPos.x < 0 || gridPos.y < 0 || gridPos.x > gridder.gridSize.x || gridPos.y > gridder.gridSize.y)
+            return;
+
+        // Zoom around the cursor, keeping the cell under it in place.
+        auto cursorCell = gridder.gridPosToCells (gridPos);
+        viewZoom *= std::pow (2.f, e.scrollDelta.y / 200.f);
+        clampView ();
+
+        auto newGridder = BoardCoords (this, lastFooterSize);
+        viewOffset = cursorCell.minus (gridPos.div (newGridder.cellPitch));
+        clampView ();
+
+        e.consume (this);
+    }
 }
\ No newline at end of file
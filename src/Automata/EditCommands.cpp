@@ -21,52 +21,53 @@
 #include <fmt/format.h>
 
 namespace OuroborosModules::Modules::Automata {
-    EditGrid copyBoardToEditGrid (const AutomataBoard& board, AutomataCell editMask) {
-        auto boardCopy = board;
-
-        auto editGrid = EditGrid ();
-        editGrid.clear ();
-        for (int y = 0; y < BoardHeight; y++) {
-            for (int x = 0; x < BoardWidth; x++)
-                editGrid.at (x, y) = testCellFlag (boardCopy.at (x, y), editMask);
+    /*
+     * PlaneDiff
+     */
+    PlaneDiff PlaneDiff::fromGrid (const AutomataBitplane& plane, const EditGrid& grid) {
+        auto diff = PlaneDiff ();
+        auto height = std::min (plane.getHeight (), grid.getHeight ());
+        auto rowWords = std::min (plane.getRowWords (), grid.getRowWords ());
+        for (int y = 0; y < height; y++) {
+            auto planeRow = plane.getRow (y);
+            auto gridRow = grid.getRow (y);
+            for (int wordI = 0; wordI < rowWords; wordI++) {
+                if (gridRow [wordI] != 0) {
+                    diff.entries.push_back ({
+                        static_cast<uint16_t> (y), static_cast<uint16_t> (wordI),
+                        gridRow [wordI], planeRow [wordI] & gridRow [wordI]
+                    });
+                }
+            }
         }
 
-        return editGrid;
+        return diff;
     }
 
-    void copyEditGridToBoard (const EditGrid& editGrid, AutomataBoard& board, AutomataCell editMask) {
-        for (int y = 0; y < BoardHeight; y++) {
-            for (int x = 0; x < BoardWidth; x++) {
-                auto& cell = board.at (x, y);
-                cell = (cell & ~editMask) | (editGrid.at (x, y) ? editMask : AutomataCell::None);
+    PlaneDiff PlaneDiff::fromPlane (const AutomataBitplane& plane) {
+        auto diff = PlaneDiff ();
+        for (int y = 0; y < plane.getHeight (); y++) {
+            auto planeRow = plane.getRow (y);
+            for (int wordI = 0; wordI < plane.getRowWords (); wordI++) {
+                if (planeRow [wordI] != 0)
+                    diff.entries.push_back ({ static_cast<uint16_t> (y), static_cast<uint16_t> (wordI), ~BoardRow (0), planeRow [wordI] });
             }
         }
-    }
 
-    void copyEditGridMaskToBoard (
-        const EditGrid& oldGrid, const EditGrid& gridMask,
-        AutomataBoard& board, AutomataCell editMask
-    ) {
-        for (int y = 0; y < BoardHeight; y++) {
-            for (int x = 0; x < BoardWidth; x++) {
-                if (!gridMask.at (x, y))
-                    continue;
+        return diff;
+    }
 
-                auto& cell = board.at (x, y);
-                cell = (cell & ~editMask) | (oldGrid.at (x, y) ? editMask : AutomataCell::None);
-            }
+    void PlaneDiff::apply (AutomataBitplane& plane, bool set) const {
+        for (const auto& entry : entries) {
+            if (auto word = getWord (plane, entry))
+                *word = set ? (*word | entry.mask) : (*word & ~entry.mask);
         }
     }
 
-    void setBoardFromEditMask (const EditGrid& gridMask, bool set, AutomataBoard& board, AutomataCell editMask) {
-        for (int y = 0; y < BoardHeight; y++) {
-            for (int x = 0; x < BoardWidth; x++) {
-                if (!gridMask.at (x, y))
-                    continue;
-
-                auto& cell = board.at (x, y);
-                cell = set ? (cell | editMask) : (cell & ~editMask);
-            }
+    void PlaneDiff::revert (AutomataBitplane& plane) const {
+        for (const auto& entry : entries) {
+            if (auto word = getWord (plane, entry))
+                *word = (*word & ~entry.mask) | entry.oldBits;
         }
     }
 
@@ -90,17 +91,18 @@ namespace OuroborosModules::Modules::Automata {
                 return;
         }
 
-        oldGrid = copyBoardToEditGrid (board, editMask);
+        oldCells = PlaneDiff::fromPlane (board.getPlane (editMask));
         this->editMask = editMask;
     }
 
     void EditCommand_Clear::undo (AutomataBoard& board) {
-        copyEditGridToBoard (oldGrid, board, editMask);
+        auto& plane = board.getPlane (editMask);
+        plane.clear ();
+        oldCells.revert (plane);
     }
 
     void EditCommand_Clear::execute (AutomataBoard& board) {
-        for (auto& cell : board)
-            cell &= ~editMask;
+        board.getPlane (editMask).clear ();
     }
 
     /*
@@ -126,19 +128,53 @@ namespace OuroborosModules::Modules::Automata {
                 return;
         }
 
-        oldGrid = copyBoardToEditGrid (board, editMask);
-
+        editedCells = PlaneDiff::fromGrid (board.getPlane (editMask), gridMask);
         this->editMask = editMask;
-        this->gridMask = gridMask;
         editSet = set;
     }
 
     void EditCommand_Toggle::undo (AutomataBoard& board) {
-        copyEditGridMaskToBoard (oldGrid, gridMask, board, editMask);
+        editedCells.revert (board.getPlane (editMask));
     }
 
     void EditCommand_Toggle::execute (AutomataBoard& board) {
-        setBoardFromEditMask (gridMask, editSet, board, editMask);
+        editedCells.apply (board.getPlane (editMask), editSet);
+    }
+
+    /*
+     * EditCommand_Resize
+     */
+    /** Gets the board's planes by index, with the live planes relative to the current generation. */
+    template<typename TBoard>
+    auto& getResizePlane (TBoard& board, int i) {
+        switch (i) {
+            case 0: return board.getLivePlane ();
+            case 1: return board.getLivePlanePrev ();
+            case 2: return board.getPlane (AutomataCell::FLAG_SeedSet);
+            default: return board.getPlane (cellFromTriggerIndex (i - 3));
+        }
+    }
+
+    EditCommand_Resize::EditCommand_Resize (const AutomataBoard& board, int width, int height)
+        : oldWidth (board.getWidth ()), oldHeight (board.getHeight ()), newWidth (width), newHeight (height) {
+        description = fmt::format (FMT_STRING ("resize automata board to {}x{}"), width, height);
+
+        for (int i = 0; i < AutomataBoard::PlaneCount; i++)
+            oldPlanes [i] = PlaneDiff::fromPlane (getResizePlane (board, i));
+    }
+
+    void EditCommand_Resize::undo (AutomataBoard& board) {
+        board.resize (oldWidth, oldHeight);
+
+        for (int i = 0; i < AutomataBoard::PlaneCount; i++) {
+            auto& plane = getResizePlane (board, i);
+            plane.clear ();
+            oldPlanes [i].revert (plane);
+        }
+    }
+
+    void EditCommand_Resize::execute (AutomataBoard& board) {
+        board.resize (newWidth, newHeight);
     }
 
     /*
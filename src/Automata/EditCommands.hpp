@@ -22,31 +22,78 @@
 #include "../PluginDef.hpp"
 
 #include "AutomataCommon.hpp"
+#include "AutomataLife.hpp"
 
+#include <algorithm>
 #include <array>
+#include <deque>
 #include <utility>
+#include <vector>
 
 namespace OuroborosModules::Modules::Automata {
+    /** Marks the cells touched by an edit, packed like a bitplane. */
     struct EditGrid {
-        std::array<bool, BoardWidth * BoardHeight> editData = { };
+      private:
+        std::vector<BoardRow> words;
+        int rowWords = 0;
+        int height = 0;
 
       public:
         EditGrid () { }
+        EditGrid (int width, int height)
+            : words ((width / BoardWordBits) * height, 0), rowWords (width / BoardWordBits), height (height) { }
+
+        int getWidth () const { return rowWords * BoardWordBits; }
+        int getHeight () const { return height; }
+        int getRowWords () const { return rowWords; }
+        const BoardRow* getRow (int y) const { return &words [y * rowWords]; }
+
+        bool at (int x, int y) const { return (getRow (y) [x / BoardWordBits] >> (x % BoardWordBits)) & 1; }
+        void set (int x, int y, bool value) {
+            auto& word = words [y * rowWords + x / BoardWordBits];
+            auto bit = BoardRow (1) << (x % BoardWordBits);
+            word = (word & ~bit) | (value ? bit : 0);
+        }
 
-        const bool& at (std::size_t x, std::size_t y) const { return editData [y * BoardWidth + x]; }
-        bool& at (std::size_t x, std::size_t y) { return editData [y * BoardWidth + x]; }
+        void clear () { std::fill (words.begin (), words.end (), 0); }
+    };
 
-        auto begin () { return editData.begin (); }
-        auto end () { return editData.end (); }
-        auto begin () const { return editData.begin (); }
-        auto end () const { return editData.end (); }
+    /** The words of a bitplane touched by an edit, and their previous contents. Untouched words aren't stored. */
+    struct PlaneDiff {
+      private:
+        struct Entry {
+            uint16_t y;
+            uint16_t wordI;
+            /** The edited cells of the word. */
+            BoardRow mask;
+            /** The previous values of the edited cells. */
+            BoardRow oldBits;
+        };
+        std::vector<Entry> entries;
+
+        /** Gets the word an entry refers to, or null if the plane no longer has it. */
+        static BoardRow* getWord (AutomataBitplane& plane, const Entry& entry) {
+            if (entry.y >= plane.getHeight () || entry.wordI >= plane.getRowWords ())
+                return nullptr;
+            return &plane.getRow (entry.y) [entry.wordI];
+        }
 
-        void clear () { editData.fill (false); }
+      public:
+        /** Records the cells of the plane marked in the grid. */
+        static PlaneDiff fromGrid (const AutomataBitplane& plane, const EditGrid& grid);
+        /** Records every live cell of the plane, for edits that overwrite all of it. */
+        static PlaneDiff fromPlane (const AutomataBitplane& plane);
+
+        /** Sets or clears all of the edited cells. */
+        void apply (AutomataBitplane& plane, bool set) const;
+        /** Restores the edited cells to their previous values. */
+        void revert (AutomataBitplane& plane) const;
     };
 
     struct EditCommand {
       public:
-        bool executed = false;
+        /** Position in the module's command queue. Commands before the queue's read position were executed. */
+        size_t queueIndex = 0;
 
         virtual ~EditCommand () = default;
 
@@ -59,7 +106,7 @@ namespace OuroborosModules::Modules::Automata {
       private:
         std::string description;
         AutomataCell editMask;
-        EditGrid oldGrid;
+        PlaneDiff oldCells;
 
       public:
         EditCommand_Clear (const AutomataBoard& board, AutomataCell editMask);
@@ -73,9 +120,7 @@ namespace OuroborosModules::Modules::Automata {
       private:
         std::string description;
 
-        EditGrid oldGrid;
-
-        EditGrid gridMask;
+        PlaneDiff editedCells;
         AutomataCell editMask;
         bool editSet;
 
@@ -87,33 +132,92 @@ namespace OuroborosModules::Modules::Automata {
         std::string getDescription () const override { return description; }
     };
 
+    struct EditCommand_Resize : EditCommand {
+      private:
+        std::string description;
+        /** The planes before resizing, in the order of getResizePlane. */
+        std::array<PlaneDiff, AutomataBoard::PlaneCount> oldPlanes;
+        int oldWidth;
+        int oldHeight;
+        int newWidth;
+        int newHeight;
+
+      public:
+        EditCommand_Resize (const AutomataBoard& board, int width, int height);
+
+        void undo (AutomataBoard& board) override;
+        void execute (AutomataBoard& board) override;
+        std::string getDescription () const override { return description; }
+    };
+
+    /**
+     * Single producer, single consumer queue of edit commands from the UI thread to the audio thread.
+     * The audio thread never frees a command: executed slots keep their reference until the UI thread reclaims them.
+     * Commands that don't fit wait on the UI thread until the audio thread catches up, so none are ever overwritten.
+     */
     struct CommandQueue {
-        static constexpr int Size = 256;
+        static constexpr size_t Size = 256;
         using TCommand = std::pair<bool, std::shared_ptr<EditCommand>>;
 
+      private:
+        TCommand data [Size];
+        /** Read position, only advanced by the audio thread. */
         std::atomic<size_t> start {0};
+        /** Write position, only advanced by the UI thread. */
         std::atomic<size_t> end {0};
-        TCommand data [Size];
 
-        void enqueue (std::shared_ptr<EditCommand> cmd, bool undo) {
-            size_t i = end % Size;
-            data [i] = std::make_pair (undo, cmd);
-            end++;
+        // UI thread only.
+        size_t reclaimed = 0;
+        std::deque<TCommand> overflow;
+
+      public:
+        /** UI thread. Returns the position the command will have in the queue. */
+        size_t enqueue (std::shared_ptr<EditCommand> cmd, bool undo) {
+            auto index = end.load (std::memory_order_relaxed) + overflow.size ();
+            overflow.emplace_back (undo, std::move (cmd));
+            flush ();
+
+            return index;
         }
 
-        TCommand consume () {
-            size_t i = start % Size;
-            auto t = data [i];
-            data [i] = std::make_pair (false, nullptr);
-            start++;
-            return t;
+        /** UI thread. Frees the executed commands and moves waiting ones into the queue. Must be called regularly. */
+        void flush () {
+            auto readPos = start.load (std::memory_order_acquire);
+            for (; reclaimed < readPos; reclaimed++)
+                data [reclaimed % Size] = TCommand ();
+
+            auto writePos = end.load (std::memory_order_relaxed);
+            while (!overflow.empty () && writePos - reclaimed < Size) {
+                data [writePos % Size] = std::move (overflow.front ());
+                overflow.pop_front ();
+                writePos++;
+            }
+            end.store (writePos, std::memory_order_release);
         }
 
-        void clear () {
-            while (!empty ())
-                consume ();
+        /** Audio thread. */
+        bool empty () const { return start.load (std::memory_order_relaxed) >= end.load (std::memory_order_acquire); }
+        /** Audio thread. Gets the oldest command. It stays valid until pop is called. */
+        std::pair<bool, EditCommand*> front () const {
+            const auto& cmd = data [start.load (std::memory_order_relaxed) % Size];
+            return std::make_pair (cmd.first, cmd.second.get ());
         }
+        /** Audio thread. Marks the oldest command as executed. */
+        void pop () { start.fetch_add (1, std::memory_order_release); }
 
-        bool empty () const { return start >= end; }
+        /** The number of commands executed so far. Commands with a lower position than this were executed. */
+        size_t getExecutedCount () const { return start.load (std::memory_order_acquire); }
+
+        /** Drops every pending command. Must only be called while the module isn't being processed. */
+        void clear () {
+            auto writePos = end.load () + overflow.size ();
+            overflow.clear ();
+            for (; reclaimed < end.load (); reclaimed++)
+                data [reclaimed % Size] = TCommand ();
+
+            reclaimed = writePos;
+            end.store (writePos);
+            start.store (writePos);
+        }
     };
 }
\ No newline at end of file
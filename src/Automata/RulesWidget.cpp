@@ -177,10 +177,16 @@ namespace OuroborosModules::Modules::Automata {
         static constexpr std::string_view LabelString = "Rule string:";
         static constexpr std::string_view LabelBirth = "Birth (B):";
         static constexpr std::string_view LabelSurvival = "Survival (S):";
+        static constexpr std::array<std::string_view, 3> LabelLargerThanLife = {
+            "Larger than Life rules",
+            "can't be edited here.",
+            "Pick a preset instead.",
+        };
 
         static constexpr float ContentsBaseY = 30;
 
         AutomataWidget* panelWidget = nullptr;
+        AutomataRules* rulesPtr;
         std::array<AutomataRulesWidgetBitButton*, NeighborsCount> birthBitButtons;
         std::array<AutomataRulesWidgetBitButton*, NeighborsCount> survivalBitButtons;
 
@@ -190,6 +196,7 @@ namespace OuroborosModules::Modules::Automata {
             using Widgets::createWidget;
 
             this->panelWidget = panelWidget;
+            rulesPtr = &rules;
             box.size = size;
 
             for (int i = 0; i < NeighborsCount; i++) {
@@ -244,6 +251,13 @@ namespace OuroborosModules::Modules::Automata {
             auto rulesString = panelWidget->getRulesWidget ()->getRulesString ();
             nvgText (args.vg, 15, ContentsBaseY + 15, rulesString.begin (), rulesString.end ());
 
+            // The B/S flags only cover the 8 neighbors, so they don't mean anything for Larger than Life rules.
+            if (rulesPtr->getRadius () > 1) {
+                for (size_t i = 0; i < LabelLargerThanLife.size (); i++)
+                    nvgText (args.vg, 5, ContentsBaseY + 30 + i * 15, LabelLargerThanLife [i].begin (), LabelLargerThanLife [i].end ());
+                return;
+            }
+
             nvgText (args.vg, 5, ContentsBaseY + 30, LabelBirth.begin (), LabelBirth.end ());
             nvgText (args.vg, 5, ContentsBaseY + 65, LabelSurvival.begin (), LabelSurvival.end ());
         }
@@ -257,15 +271,18 @@ namespace OuroborosModules::Modules::Automata {
             auto buttonBaseX = 8;
             auto birthButtonY = ContentsBaseY + 30 + 6;
             auto survivalButtonY = ContentsBaseY + 65 + 6;
+            auto editable = rulesPtr->getRadius () <= 1;
 
             for (int i = 0; i < NeighborsCount; i++) {
                 auto birthButton = birthBitButtons [i];
                 birthButton->box.size = Vec (buttonSize);
                 birthButton->box.pos = Vec (buttonBaseX + i * (buttonSize + buttonSpacing), birthButtonY);
+                birthButton->visible = editable;
 
                 auto survivalButton = survivalBitButtons [i];
                 survivalButton->box.size = Vec (buttonSize);
                 survivalButton->box.pos = Vec (buttonBaseX + i * (buttonSize + buttonSpacing), survivalButtonY);
+                survivalButton->visible = editable;
             }
 
             doDraw (args, 0);
@@ -311,7 +328,7 @@ namespace OuroborosModules::Modules::Automata {
         if (module == nullptr)
             return;
 
-        rules = module->getLifeBoard ().getRules ();
+        rules = module->getDisplayData ().rules;
         updateRuleString (true);
 
         show ();
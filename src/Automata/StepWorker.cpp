@@ -0,0 +1,147 @@
+/*
+ *  OuroborosModules
+ *  Copyright (C) 2024-2025 Chronos "phantombeta" Ouroboros
+ *  Copyright (C) 2016-2023 VCV
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "StepWorker.hpp"
+
+#include <algorithm>
+#include <chrono>
+
+namespace OuroborosModules::Modules::Automata {
+    /** Board cost, in words of Life or cells of Larger than Life, from which stepping is handed to the worker. */
+    static constexpr int MinRequestCost = 256;
+    /** How often the worker polls for requests while busy. It backs off up to the maximum while idle. */
+    static constexpr auto MinPollInterval = std::chrono::milliseconds (1);
+    static constexpr auto MaxPollInterval = std::chrono::milliseconds (32);
+
+    /*
+     * AutomataStepWorker
+     */
+    AutomataStepWorker::AutomataStepWorker () {
+        thread = std::thread ([this] { run (); });
+    }
+
+    AutomataStepWorker::~AutomataStepWorker () {
+        {
+            std::lock_guard<std::mutex> lock (shutdownMutex);
+            running = false;
+        }
+        shutdownCondition.notify_one ();
+        thread.join ();
+    }
+
+    std::shared_ptr<AutomataStepWorker> AutomataStepWorker::acquire () {
+        static std::mutex instanceMutex;
+        static std::weak_ptr<AutomataStepWorker> instance;
+
+        std::lock_guard<std::mutex> lock (instanceMutex);
+        auto worker = instance.lock ();
+        if (worker == nullptr)
+            instance = worker = std::make_shared<AutomataStepWorker> ();
+
+        return worker;
+    }
+
+    void AutomataStepWorker::addJob (AutomataStepJob* job) {
+        std::lock_guard<std::mutex> lock (jobsMutex);
+        jobs.push_back (job);
+    }
+
+    void AutomataStepWorker::removeJob (AutomataStepJob* job) {
+        std::lock_guard<std::mutex> lock (jobsMutex);
+        jobs.erase (std::remove (jobs.begin (), jobs.end (), job), jobs.end ());
+    }
+
+    void AutomataStepWorker::run () {
+        auto pollInterval = std::chrono::milliseconds (MinPollInterval);
+        while (true) {
+            if (wakeRequested.exchange (false, std::memory_order_acquire)) {
+                pollInterval = MinPollInterval;
+
+                std::lock_guard<std::mutex> lock (jobsMutex);
+                for (auto job : jobs)
+                    job->process ();
+                continue;
+            }
+
+            // A request that comes in while sleeping waits for the next poll. If the clock is faster than that,
+            // the audio thread just steps the board itself.
+            std::unique_lock<std::mutex> lock (shutdownMutex);
+            if (shutdownCondition.wait_for (lock, pollInterval, [this] { return !running; }))
+                return;
+
+            pollInterval = std::min (pollInterval * 2, std::chrono::milliseconds (MaxPollInterval));
+        }
+    }
+
+    /*
+     * AutomataStepJob
+     */
+    AutomataStepJob::AutomataStepJob () {
+        worker = AutomataStepWorker::acquire ();
+        worker->addJob (this);
+    }
+
+    AutomataStepJob::~AutomataStepJob () {
+        worker->removeJob (this);
+    }
+
+    void AutomataStepJob::process () {
+        auto expected = JobState::Requested;
+        if (!state.compare_exchange_strong (expected, JobState::Working, std::memory_order_acquire))
+            return;
+
+        result = source;
+        stepLife (source, result, rules);
+        state.store (JobState::Done, std::memory_order_release);
+    }
+
+    bool AutomataStepJob::isWorthRequesting (const AutomataLife& life) {
+        // Life steps a word of cells at a time, while Larger than Life sums every cell's neighbourhood.
+        const auto& livePlane = life.getBoard ().getLivePlane ();
+        auto cost = life.getRules ().getRadius () > 1 ? livePlane.getWidth () * livePlane.getHeight () : livePlane.getWordCount ();
+        return cost >= MinRequestCost;
+    }
+
+    bool AutomataStepJob::isAvailable () const {
+        auto curState = state.load (std::memory_order_acquire);
+        return curState == JobState::Idle || curState == JobState::Done;
+    }
+
+    bool AutomataStepJob::hasJob (uint64_t version) const {
+        return state.load (std::memory_order_acquire) != JobState::Idle && jobVersion == version;
+    }
+
+    void AutomataStepJob::request (const AutomataLife& life) {
+        assert (isAvailable ());
+
+        source = life.getBoard ().getLivePlane ();
+        rules = life.getRules ();
+        jobVersion = life.getVersion ();
+
+        state.store (JobState::Requested, std::memory_order_release);
+        worker->wake ();
+    }
+
+    const AutomataBitplane* AutomataStepJob::getResult (uint64_t version) const {
+        if (state.load (std::memory_order_acquire) != JobState::Done || jobVersion != version)
+            return nullptr;
+
+        return &result;
+    }
+}
\ No newline at end of file
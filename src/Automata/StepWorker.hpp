@@ -0,0 +1,123 @@
+/*
+ *  OuroborosModules
+ *  Copyright (C) 2024-2025 Chronos "phantombeta" Ouroboros
+ *  Copyright (C) 2016-2023 VCV
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include "../PluginDef.hpp"
+
+#include "AutomataCommon.hpp"
+#include "AutomataLife.hpp"
+
+#include <atomic>
+#include <condition_variable>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace OuroborosModules::Modules::Automata {
+    struct AutomataStepJob;
+
+    /**
+     * One background thread shared by every Automata, calculating the next generation of the boards that asked for it.
+     * Requests only set an atomic flag, so the audio thread never locks or makes a syscall. The worker polls the flag,
+     * backing off while nothing is requested. It lives for as long as any job holds on to it.
+     */
+    struct AutomataStepWorker {
+      private:
+        std::thread thread;
+        std::atomic<bool> wakeRequested { false };
+
+        // Guards the list of jobs. Held by the worker while it steps boards, so a job can't be removed mid-step.
+        std::mutex jobsMutex;
+        std::vector<AutomataStepJob*> jobs;
+
+        // Only used to cut the worker's sleep short when shutting down.
+        std::mutex shutdownMutex;
+        std::condition_variable shutdownCondition;
+        bool running = true;
+
+        void run ();
+
+      public:
+        AutomataStepWorker ();
+        ~AutomataStepWorker ();
+
+        AutomataStepWorker (const AutomataStepWorker&) = delete;
+        AutomataStepWorker& operator= (const AutomataStepWorker&) = delete;
+
+        /** Gets the shared worker, starting it if no job is using it. */
+        static std::shared_ptr<AutomataStepWorker> acquire ();
+
+        void addJob (AutomataStepJob* job);
+        void removeJob (AutomataStepJob* job);
+        /** Makes the worker look for requested jobs when it next polls. Lock-free, so it's safe on the audio thread. */
+        void wake () { wakeRequested.store (true, std::memory_order_release); }
+    };
+
+    /**
+     * A board's slot in the shared step worker, so the clock edge only has to pick up the next generation.
+     * Only the audio thread may request and take jobs.
+     */
+    struct AutomataStepJob {
+        friend AutomataStepWorker;
+
+      private:
+        enum class JobState : int {
+            Idle,
+            Requested,
+            Working,
+            Done,
+        };
+
+        std::shared_ptr<AutomataStepWorker> worker;
+        std::atomic<JobState> state { JobState::Idle };
+
+        // Owned by the worker while a job is requested or in progress, and by the audio thread otherwise.
+        AutomataBitplane source;
+        AutomataBitplane result;
+        AutomataRules rules;
+        uint64_t jobVersion = 0;
+
+        /** Worker thread. Steps the board if a job was requested. */
+        void process ();
+
+      public:
+        AutomataStepJob ();
+        ~AutomataStepJob ();
+
+        AutomataStepJob (const AutomataStepJob&) = delete;
+        AutomataStepJob& operator= (const AutomataStepJob&) = delete;
+
+        /**
+         * Whether the board takes long enough to step that handing it to the worker pays off.
+         * Waking the worker costs a few microseconds, which is more than stepping a small Life board takes.
+         */
+        static bool isWorthRequesting (const AutomataLife& life);
+
+        /** Audio thread. True if the job can be requested again. */
+        bool isAvailable () const;
+        /** Audio thread. True if a job for the given version was requested, finished or not. */
+        bool hasJob (uint64_t version) const;
+        /** Audio thread. Starts calculating the generation after the current one. Must only be called when available. */
+        void request (const AutomataLife& life);
+        /** Audio thread. Gets the finished generation if it was calculated from the given version. */
+        const AutomataBitplane* getResult (uint64_t version) const;
+    };
+}
\ No newline at end of file
@@ -60,6 +60,9 @@ namespace OuroborosModules::Modules::Automata {
         addInput (createInputCentered<CableJackInput> (findNamed ("input_LengthEnable", Vec ()), moduleT, AutomataModule::INPUT_LENGTH_ENABLE));
         addInput (createInputCentered<CableJackInput> (findNamed ("input_LengthCV", Vec ()), moduleT, AutomataModule::INPUT_LENGTH_CV));
 
+        addInput (createInputCentered<CableJackInput> (findNamed ("input_Reverse", Vec ()), moduleT, AutomataModule::INPUT_REVERSE));
+        addInput (createInputCentered<CableJackInput> (findNamed ("input_Scrub", Vec ()), moduleT, AutomataModule::INPUT_SCRUB));
+
         // Outputs
         forEachMatched ("output_Trigger(\\d+)", [&] (std::vector<std::string> captures, Vec pos) {
             auto i = stoi (captures [0]) - 1;
@@ -68,6 +71,20 @@ namespace OuroborosModules::Modules::Automata {
             addOutput (createOutputCentered<CableJackOutput> (pos, moduleT, AutomataModule::OUTPUT_TRIGGER + i));
         });
         addOutput (createOutputCentered<CableJackOutput> (findNamed ("output_EOC", Vec ()), moduleT, AutomataModule::OUTPUT_EOC));
+        addOutput (createOutputCentered<CableJackOutput> (findNamed ("output_CycleLength", Vec ()), moduleT, AutomataModule::OUTPUT_CYCLE_LENGTH));
+        addOutput (createOutputCentered<CableJackOutput> (findNamed ("output_Stagnation", Vec ()), moduleT, AutomataModule::OUTPUT_STAGNATION));
+        forEachMatched ("output_RowDensity(\\d+)", [&] (std::vector<std::string> captures, Vec pos) {
+            auto i = stoi (captures [0]) - 1;
+            if (i < 0 || i >= DensityOutputCount)
+                return LOG_WARN (FMT_STRING ("Automata panel has invalid row density output #{}"), i);
+            addOutput (createOutputCentered<CableJackOutput> (pos, moduleT, AutomataModule::OUTPUT_ROW_DENSITY + i));
+        });
+        forEachMatched ("output_ColumnDensity(\\d+)", [&] (std::vector<std::string> captures, Vec pos) {
+            auto i = stoi (captures [0]) - 1;
+            if (i < 0 || i >= DensityOutputCount)
+                return LOG_WARN (FMT_STRING ("Automata panel has invalid column density output #{}"), i);
+            addOutput (createOutputCentered<CableJackOutput> (pos, moduleT, AutomataModule::OUTPUT_COLUMN_DENSITY + i));
+        });
 
         // Params
         addChild (createLightParamCentered<LightButton> (findNamed ("param_StepButton", Vec ()), moduleT, AutomataModule::PARAM_STEP_BUTTON, AutomataModule::LIGHT_STEP_BUTTON));
@@ -84,7 +101,7 @@ namespace OuroborosModules::Modules::Automata {
         addChild (createParamCentered<MetalKnobSmall> (findNamed ("param_ModeSelect", Vec ()), moduleT, AutomataModule::PARAM_MODE_SELECT));
 
         auto displayBox = findNamedBox ("widget_Board", rack::math::Rect ());
-        auto boardWidget = createWidget<AutomataBoardWidget> (displayBox.pos, displayBox.size, this);
+        boardWidget = createWidget<AutomataBoardWidget> (displayBox.pos, displayBox.size, this);
         addChild (boardWidget);
 
         rulesWidget = createWidget<AutomataRulesWidget> (Vec (), displayBox.size, this);
@@ -108,7 +125,7 @@ namespace OuroborosModules::Modules::Automata {
         menu->addChild (new rack::ui::MenuSeparator);
         menu->addChild (createMenuLabel ("Actions"));
         menu->addChild (createMenuItem ("Clear seed", "", [=] {
-            moduleT->addEditCommand<EditCommand_Clear> (moduleT->lifeBoard.getBoard (), AutomataCell::FLAG_SeedSet);
+            moduleT->addEditCommand<EditCommand_Clear> (boardWidget->getBoard (), AutomataCell::FLAG_SeedSet);
         }));
 
         menu->addChild (new rack::ui::MenuSeparator);
@@ -124,6 +141,8 @@ namespace OuroborosModules::Modules::Automata {
             }
         }));
 
+        menu->addChild (createSubmenuItem ("Board size", "", [=] (Menu* menu) { generateBoardSizeContextMenu (menu); }));
+
         menu->addChild (new rack::ui::MenuEntry);
         menu->addChild (createBoolPtrMenuItemWithHistory (
             "Randomize on manual reset", "",
@@ -140,16 +159,111 @@ namespace OuroborosModules::Modules::Automata {
             "Toggle Automata \"Momentary length enable input\"",
             &AutomataModule::momentaryLengthEnable
         ));
+        menu->addChild (createBoolPtrMenuItemWithHistory (
+            "Automatic reset on cycle", "",
+            "Toggle Automata \"Automatic reset on cycle\"",
+            &AutomataModule::resetOnCycle
+        ));
+        menu->addChild (createSubmenuItem ("Audio-rate stepping", "", [=] (Menu* menu) { generateAudioRateContextMenu (menu); }));
+        menu->addChild (createSubmenuItem ("Rewind length", "", [=] (Menu* menu) { generateRewindContextMenu (menu); }));
+
+        menu->addChild (new rack::ui::MenuSeparator);
+        menu->addChild (createMenuLabel (fmt::format (FMT_STRING ("Random seed: {:016X}"), moduleT->getRandomSeed ())));
+        menu->addChild (createMenuItem ("New random seed", "", [=] { moduleT->setRandomSeed (rack::random::u64 ()); }));
+        menu->addChild (createBoolPtrMenuItemWithHistory (
+            "Reseed on reset", "",
+            "Toggle Automata \"Reseed on reset\"",
+            &AutomataModule::reseedOnReset
+        ));
+    }
+
+    void AutomataWidget::generateAudioRateContextMenu (rack::ui::Menu* menu) {
+        auto curDivision = moduleT->audioRateDivision;
+        for (int division = 0; division <= MaxAudioRateDivision; division = std::max (division * 2, 1)) {
+            std::string label;
+            if (division == 0)
+                label = "Off";
+            else if (division == 1)
+                label = "Every sample";
+            else
+                label = fmt::format (FMT_STRING ("Every {} samples"), division);
+
+            menu->addChild (rack::createCheckMenuItem (label, "",
+                [=] { return curDivision == division; },
+                [=] {
+                    createContextMenuHistory<int> ("Set Automata audio-rate stepping", [=] (AutomataModule* module, int value) {
+                        module->audioRateDivision = value;
+                    }, curDivision, division);
+                }
+            ));
+        }
+    }
+
+    void AutomataWidget::generateRewindContextMenu (rack::ui::Menu* menu) {
+        menu->addChild (rack::createMenuLabel ("Larger boards may remember fewer generations"));
+
+        auto curLength = moduleT->rewindLength;
+        for (int length = 64; length <= MaxRewindLength; length *= 4) {
+            menu->addChild (rack::createCheckMenuItem (fmt::format (FMT_STRING ("{} generations"), length), "",
+                [=] { return curLength == length; },
+                [=] {
+                    createContextMenuHistory<int> ("Set Automata rewind length", [=] (AutomataModule* module, int value) {
+                        module->rewindLength = value;
+                    }, curLength, length);
+                }
+            ));
+        }
+    }
+
+    void AutomataWidget::generateBoardSizeContextMenu (rack::ui::Menu* menu) {
+        using rack::createCheckMenuItem;
+        using rack::createMenuItem;
+
+        static const std::pair<int, int> boardSizes [] = {
+            { DefaultBoardWidth, DefaultBoardHeight },
+            { 32, 32 },
+            { 64, 40 },
+            { 64, 64 },
+            { 128, 80 },
+            { 128, 128 },
+            { 256, 160 },
+            { 256, 256 },
+        };
+
+        for (auto [width, height] : boardSizes) {
+            menu->addChild (createCheckMenuItem (
+                fmt::format (FMT_STRING ("{}x{}"), width, height), "",
+                [=] { return boardWidget->getBoard ().getWidth () == width && boardWidget->getBoard ().getHeight () == height; },
+                [=] { moduleT->addEditCommand<EditCommand_Resize> (boardWidget->getBoard (), width, height); }
+            ));
+        }
+
+        menu->addChild (new rack::ui::MenuSeparator);
+        menu->addChild (createMenuItem ("Reset view", "", [=] { boardWidget->resetView (); }, !boardWidget->canZoom ()));
     }
 
     void AutomataWidget::generateRulesContextMenu (rack::ui::Menu* menu) {
         using rack::createCheckMenuItem;
         using rack::createMenuItem;
         using rack::createMenuLabel;
+        using rack::createSubmenuItem;
 
         menu->addChild (createMenuLabel ("Current rule:"));
-        menu->addChild (createMenuLabel (moduleT->lifeBoard.getRules ().getRuleString ()));
+        menu->addChild (createMenuLabel (moduleT->getDisplayData ().rules.getRuleString ()));
         menu->addChild (createMenuItem ("Edit rule", "", [=] { rulesWidget->open (); }));
+        menu->addChild (createSubmenuItem ("Cell states", "", [=] (rack::ui::Menu* menu) {
+            auto curRules = moduleT->getDisplayData ().rules;
+            for (int states = 2; states <= MaxRuleStates; states++) {
+                auto newRules = curRules;
+                newRules.setStates (states);
+
+                menu->addChild (createCheckMenuItem (
+                    states > 2 ? fmt::format (FMT_STRING ("{} (Generations)"), states) : "2 (Live/dead)", "",
+                    [=] { return curRules.getStates () == states; },
+                    [=] { APP->history->push (new HistoryChangeRules (moduleT, newRules)); }
+                ));
+            }
+        }));
 
         menu->addChild (new rack::ui::MenuSeparator);
         menu->addChild (createMenuLabel ("Preset rules"));
@@ -159,7 +273,7 @@ namespace OuroborosModules::Modules::Automata {
 
             menu->addChild (createCheckMenuItem (
                 name, rules.getRuleString (),
-                [=] { return rules == moduleT->getLifeBoard ().getRules (); },
+                [=] { return rules == moduleT->getDisplayData ().rules; },
                 [=] { APP->history->push (new HistoryChangeRules (moduleT, rules)); }
             ));
         }
@@ -289,7 +403,7 @@ namespace OuroborosModules::Modules::Automata {
         }));
 
         menu->addChild (createMenuItem ("Clear trigger locations", "", [=] {
-            moduleT->addEditCommand<EditCommand_Clear> (moduleT->lifeBoard.getBoard (), cellFromTriggerIndex (i));
+            moduleT->addEditCommand<EditCommand_Clear> (boardWidget->getBoard (), cellFromTriggerIndex (i));
         }));
     }
 }
\ No newline at end of file
@@ -50,61 +50,52 @@ namespace OuroborosModules::Modules::Bernoulli {
 
             configLight (LIGHT_STATE_A + i, fmt::format (FMT_STRING ("Channel {} A state"), i + 1));
             configLight (LIGHT_STATE_B + i, fmt::format (FMT_STRING ("Channel {} B state"), i + 1));
-
-            bernoulliGates [i] = BernoulliGate ([=] {
-                auto cv = inputs [INPUT_PROBABILITY_CV + i].getVoltage () / 10.f
-                        * params [PARAM_PROBABILITY_CV + i].getValue ();
-                return params [PARAM_PROBABILITY + i].getValue () + cv;
-            });
         }
 
+        reseedOnReset = false;
+        setRandomSeed (rack::random::u64 ());
+
+        clockParams = DSP::ClockDivider (32, rack::random::u32 ());
         clockLights = DSP::ClockDivider (32, rack::random::u32 ());
 
         randomizeProbability = true;
         randomizeProbabilityCV = true;
         randomizeModes = true;
-    }
-
-    BernoulliGate::BernoulliGate (std::function<float ()> probabilityFunc)
-        : schmittTrigger (), probabilityFunc (probabilityFunc) {
-        schmittTrigger.reset ();
-
-        modeToggle = false;
-        modeLatch = false;
 
-        selectedOutput = false;
+        processParams ();
     }
 
-    rack::math::Vec BernoulliGate::process (float gateInput) {
-        auto isTriggered = schmittTrigger.process (gateInput, Constants::TriggerThreshLow, Constants::TriggerThreshHigh);
-
-        if (isTriggered) {
-            auto outcome = rack::random::uniform () < probabilityFunc ();
-            if (!modeToggle)
-                selectedOutput = outcome;
-            else if (outcome)
-                selectedOutput ^= true;
-        }
+    void BernoulliGate::flip (int bankI, rack::simd::float_4 triggered, rack::simd::float_4 probabilityCV, rack::simd::float_4 randomValues) {
+        auto outcome = randomValues < probability + probabilityCV * probabilityCVScale;
+        auto& selected = selectedOutputs [bankI];
+        if (!modeToggle)
+            selected = rack::simd::ifelse (triggered, outcome, selected);
+        else
+            selected ^= triggered & outcome;
+    }
 
-        auto outputs = rack::math::Vec (boolToGate (!selectedOutput), boolToGate (selectedOutput));
-        if (modeLatch || schmittTrigger.isHigh ())
-            return outputs;
+    void BernoulliGate::getOutputs (int bankI, rack::simd::float_4& outputA, rack::simd::float_4& outputB) {
+        using rack::simd::float_4;
 
-        return rack::math::Vec (0.f);
+        auto active = modeLatch ? float_4::mask () : schmittTriggers [bankI].isHigh ();
+        auto selected = selectedOutputs [bankI];
+        outputA = rack::simd::ifelse (active & ~selected, float_4 (10.f), float_4 (0.f));
+        outputB = rack::simd::ifelse (active & selected, float_4 (10.f), float_4 (0.f));
     }
 
     json_t* BernoulliGate::dataToJson () const {
         auto rootJ = json_object ();
 
-        json_object_set_new_bool (rootJ, "selectedOutput", selectedOutput);
-        int schmittTriggerState;
-        switch (schmittTrigger.s) {
-            default:
-            case rack::dsp::SchmittTrigger::UNINITIALIZED: schmittTriggerState = -1; break;
-            case rack::dsp::SchmittTrigger::LOW:  schmittTriggerState = 0; break;
-            case rack::dsp::SchmittTrigger::HIGH: schmittTriggerState = 1; break;
+        auto selectedOutputsJ = json_array ();
+        auto schmittTriggersJ = json_array ();
+        for (int c = 0; c < Constants::MaxPolyphony; c++) {
+            auto bankI = c / SIMDBankSize;
+            auto laneI = c % SIMDBankSize;
+            json_array_append_new (selectedOutputsJ, json_boolean (selectedOutputs [bankI] [laneI] != 0.f));
+            json_array_append_new (schmittTriggersJ, json_boolean (schmittTriggers [bankI].state [laneI] != 0.f));
         }
-        json_object_set_new_int (rootJ, "schmittTrigger", schmittTriggerState);
+        json_object_set_new (rootJ, "selectedOutputs", selectedOutputsJ);
+        json_object_set_new (rootJ, "schmittTriggers", schmittTriggersJ);
 
         return rootJ;
     }
@@ -113,15 +104,32 @@ namespace OuroborosModules::Modules::Bernoulli {
         if (!json_is_object (rootJ))
             return false;
 
+        auto setLane = [] (rack::simd::float_4& vec, int c, bool value) {
+            vec [c % SIMDBankSize] = value ? rack::simd::float_4::mask () [0] : 0.f;
+        };
+
+        auto selectedOutputsJ = json_object_get (rootJ, "selectedOutputs");
+        auto schmittTriggersJ = json_object_get (rootJ, "schmittTriggers");
+        if (json_is_array (selectedOutputsJ) && json_is_array (schmittTriggersJ)) {
+            for (int c = 0; c < Constants::MaxPolyphony; c++) {
+                auto bankI = c / SIMDBankSize;
+                setLane (selectedOutputs [bankI], c, json_is_true (json_array_get (selectedOutputsJ, c)));
+                // Missing entries default to high, so a held gate doesn't retrigger after loading.
+                auto triggerJ = json_array_get (schmittTriggersJ, c);
+                setLane (schmittTriggers [bankI].state, c, triggerJ == nullptr || json_is_true (triggerJ));
+            }
+
+            return true;
+        }
+
+        // Monophonic patches saved before polyphony was supported.
+        bool selectedOutput = false;
         json_object_try_get_bool (rootJ, "selectedOutput", selectedOutput);
         int schmittTriggerState = -1;
         json_object_try_get_int (rootJ, "schmittTrigger", schmittTriggerState);
-        switch (schmittTriggerState) {
-            default:
-            case -1: schmittTrigger.s = rack::dsp::SchmittTrigger::UNINITIALIZED; break;
-            case  0: schmittTrigger.s = rack::dsp::SchmittTrigger::LOW; break;
-            case  1: schmittTrigger.s = rack::dsp::SchmittTrigger::HIGH; break;
-        }
+
+        setLane (selectedOutputs [0], 0, selectedOutput);
+        setLane (schmittTriggers [0].state, 0, schmittTriggerState != 0);
 
         return true;
     }
@@ -138,6 +146,9 @@ namespace OuroborosModules::Modules::Bernoulli {
         json_object_set_new_int (rootJ, "randomizeProbabilityCV", randomizeProbabilityCV);
         json_object_set_new_int (rootJ, "randomizeModes", randomizeModes);
 
+        json_object_set_new_int (rootJ, "randomSeed", static_cast<json_int_t> (randomSeed.load ()));
+        json_object_set_new_bool (rootJ, "reseedOnReset", reseedOnReset);
+
         return rootJ;
     }
 
@@ -150,39 +161,99 @@ namespace OuroborosModules::Modules::Bernoulli {
         json_object_try_get_int (rootJ, "randomizeProbability", randomizeProbability);
         json_object_try_get_int (rootJ, "randomizeProbabilityCV", randomizeProbabilityCV);
         json_object_try_get_int (rootJ, "randomizeModes", randomizeModes);
+
+        auto seed = static_cast<json_int_t> (randomSeed.load ());
+        json_object_try_get_int (rootJ, "randomSeed", seed);
+        setRandomSeed (static_cast<uint64_t> (seed));
+        json_object_try_get_bool (rootJ, "reseedOnReset", reseedOnReset);
+    }
+
+    void BernoulliModule::processParams () {
+        for (int i = 0; i < GatesCount; i++) {
+            auto& gate = bernoulliGates [i];
+
+            auto modeValue = static_cast<int> (params [PARAM_MODE + i].getValue ());
+            gate.modeLatch = modeValue >= 2;
+            gate.modeToggle = (modeValue % 2) == 1;
+
+            gate.probability = params [PARAM_PROBABILITY + i].getValue ();
+            gate.probabilityCVScale = params [PARAM_PROBABILITY_CV + i].getValue () / 10.f;
+        }
     }
 
     void BernoulliModule::process (const ProcessArgs& args) {
+        using rack::simd::float_4;
+
         auto lightTime = args.sampleTime * clockLights.division;
         auto lightClocked = clockLights.process ();
 
+        if (reseedSignal.exchange (false))
+            rng.seed (randomSeed.load ());
+
+        if (clockParams.process ())
+            processParams ();
+
         int lastConnected = -1;
         for (int i = 0; i < GatesCount; i++) {
             auto& gate = bernoulliGates [i];
 
-            auto modeValue = static_cast<int> (params [PARAM_MODE + i].getValue ());
-            gate.modeLatch = modeValue >= 2;
-            gate.modeToggle = (modeValue % 2) == 1;
-
-            float gateInput;
-            if (!inputs [INPUT_TRIGGER + i].isConnected ())
-                gateInput = inputs [INPUT_TRIGGER + (lastConnected >= 0 ? lastConnected : i)].getVoltage ();
-            else {
-                gateInput = inputs [INPUT_TRIGGER + i].getVoltage ();
+            // Unpatched trigger inputs are normalled to the closest patched one above them.
+            if (inputs [INPUT_TRIGGER + i].isConnected ())
                 lastConnected = i;
+            auto& triggerInput = inputs [INPUT_TRIGGER + (lastConnected >= 0 ? lastConnected : i)];
+            auto& probabilityInput = inputs [INPUT_PROBABILITY_CV + i];
+
+            auto channels = std::max (triggerInput.getChannels (), 1);
+            outputs [OUTPUT_A + i].setChannels (channels);
+            outputs [OUTPUT_B + i].setChannels (channels);
+
+            // Random numbers are only generated once per gate and sample, and only if a channel was triggered.
+            alignas (16) float randomValues [Constants::MaxPolyphony];
+            auto randomValuesReady = false;
+
+            auto lightA = float_4 (0.f);
+            auto lightB = float_4 (0.f);
+            for (int c = 0; c < channels; c += BernoulliGate::SIMDBankSize) {
+                auto bankI = c / BernoulliGate::SIMDBankSize;
+
+                auto triggered = gate.processTrigger (bankI, triggerInput.getVoltageSimd<float_4> (c));
+                if (rack::simd::movemask (triggered) != 0) {
+                    if (!randomValuesReady) {
+                        rng.nextUniform (randomValues);
+                        randomValuesReady = true;
+                    }
+
+                    gate.flip (bankI, triggered, probabilityInput.getPolyVoltageSimd<float_4> (c), float_4::load (&randomValues [c]));
+                }
+
+                float_4 outputA, outputB;
+                gate.getOutputs (bankI, outputA, outputB);
+                outputs [OUTPUT_A + i].setVoltageSimd (outputA, c);
+                outputs [OUTPUT_B + i].setVoltageSimd (outputB, c);
+
+                // Lanes past the channel count aren't outputs, so they can't light anything up.
+                auto usedLanes = (float_4 (0, 1, 2, 3) + c) < channels;
+                lightA = rack::simd::fmax (lightA, outputA & usedLanes);
+                lightB = rack::simd::fmax (lightB, outputB & usedLanes);
             }
 
-            auto result = gate.process (gateInput);
-            outputs [OUTPUT_A + i].setVoltage (result.x);
-            outputs [OUTPUT_B + i].setVoltage (result.y);
-
+            // The lights show whether any channel is routed to each output.
             if (lightClocked) {
-                lights [LIGHT_STATE_A + i].setBrightnessSmooth (result.x, lightTime);
-                lights [LIGHT_STATE_B + i].setBrightnessSmooth (result.y, lightTime);
+                auto brightnessA = std::max ({ lightA [0], lightA [1], lightA [2], lightA [3], }) / 10.f;
+                auto brightnessB = std::max ({ lightB [0], lightB [1], lightB [2], lightB [3], }) / 10.f;
+                lights [LIGHT_STATE_A + i].setBrightnessSmooth (brightnessA, lightTime);
+                lights [LIGHT_STATE_B + i].setBrightnessSmooth (brightnessB, lightTime);
             }
         }
     }
 
+    void BernoulliModule::onReset (const ResetEvent& e) {
+        ModuleBase::onReset (e);
+
+        if (reseedOnReset)
+            reseedSignal.store (true);
+    }
+
     void BernoulliModule::onRandomize (const RandomizeEvent& e) {
         for (int i = 0; i < GatesCount; i++) {
             getParamQuantity (PARAM_PROBABILITY + i)->randomizeEnabled = randomizeProbability;
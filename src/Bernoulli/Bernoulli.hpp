@@ -19,25 +19,36 @@
 #pragma once
 
 #include "../DSP/ClockDivider.hpp"
+#include "../DSP/Random.hpp"
 #include "../ModuleBase.hpp"
 #include "../PluginDef.hpp"
 #include "../UI/CommonWidgets.hpp"
 #include "../UI/WidgetBase.hpp"
 
+#include <atomic>
+
 namespace OuroborosModules::Modules::Bernoulli {
     struct BernoulliGate {
-        rack::dsp::SchmittTrigger schmittTrigger;
+        static constexpr int SIMDBankSize = 4;
+        static constexpr int SIMDBankCount = Constants::MaxPolyphony / SIMDBankSize;
+
+        rack::dsp::TSchmittTrigger<rack::simd::float_4> schmittTriggers [SIMDBankCount];
 
-        bool modeToggle;
-        bool modeLatch;
+        bool modeToggle = false;
+        bool modeLatch = false;
 
-        std::function<float ()> probabilityFunc;
-        bool selectedOutput;
+        /** Updated at control rate. The CV is added when the gate is triggered. */
+        float probability = .5f;
+        float probabilityCVScale = 0.f;
 
-        BernoulliGate () : BernoulliGate (nullptr) { }
-        BernoulliGate (std::function<float ()> probabilityFunc);
+        /** Lane masks, set for channels currently routed to output B. */
+        rack::simd::float_4 selectedOutputs [SIMDBankCount] = {};
 
-        rack::math::Vec process (float gateInput);
+        rack::simd::float_4 processTrigger (int bankI, rack::simd::float_4 gateInput) {
+            return schmittTriggers [bankI].process (gateInput, Constants::TriggerThreshLow, Constants::TriggerThreshHigh);
+        }
+        void flip (int bankI, rack::simd::float_4 triggered, rack::simd::float_4 probabilityCV, rack::simd::float_4 randomValues);
+        void getOutputs (int bankI, rack::simd::float_4& outputA, rack::simd::float_4& outputB);
 
         json_t* dataToJson () const;
         bool dataFromJson (json_t* rootJ);
@@ -73,19 +84,37 @@ namespace OuroborosModules::Modules::Bernoulli {
         };
 
         BernoulliGate bernoulliGates [GatesCount];
+        DSP::Xoshiro128PlusBatch<Constants::MaxPolyphony> rng;
 
+        DSP::ClockDivider clockParams;
         DSP::ClockDivider clockLights;
 
         bool randomizeProbability;
         bool randomizeProbabilityCV;
         bool randomizeModes;
 
+        /** Restart the random sequence from the saved seed when the module is initialized. */
+        bool reseedOnReset;
+
+      private:
+        std::atomic<uint64_t> randomSeed;
+        std::atomic<bool> reseedSignal;
+
+      public:
         BernoulliModule ();
 
+        uint64_t getRandomSeed () { return randomSeed.load (); }
+        void setRandomSeed (uint64_t seed) {
+            randomSeed.store (seed);
+            reseedSignal.store (true);
+        }
+
         json_t* dataToJson () override;
         void dataFromJson (json_t* rootJ) override;
 
         void process (const ProcessArgs& args) override;
+        void processParams ();
+        void onReset (const ResetEvent& e) override;
         void onRandomize (const RandomizeEvent& e) override;
     };
 
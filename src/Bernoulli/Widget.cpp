@@ -134,5 +134,13 @@ namespace OuroborosModules::Modules::Bernoulli {
         menu->addChild (createBoolPtrMenuItemWithHistory (
             "Randomize modes", "", "Toggle Bernoulli \"Randomize modes\"", &BernoulliModule::randomizeModes
         ));
+
+        // Seed options
+        menu->addChild (new rack::ui::MenuSeparator);
+        menu->addChild (rack::createMenuLabel (fmt::format (FMT_STRING ("Random seed: {:016X}"), moduleT->getRandomSeed ())));
+        menu->addChild (rack::createMenuItem ("New random seed", "", [=] { moduleT->setRandomSeed (rack::random::u64 ()); }));
+        menu->addChild (createBoolPtrMenuItemWithHistory (
+            "Reseed on reset", "", "Toggle Bernoulli \"Reseed on reset\"", &BernoulliModule::reseedOnReset
+        ));
     }
 }
\ No newline at end of file
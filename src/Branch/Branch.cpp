@@ -41,7 +41,7 @@ namespace OuroborosModules::Modules::Branch {
     }
 
     json_t* BranchModule::dataToJson () {
-        auto rootJ = ModuleBase::dataToJson ();
+        auto rootJ = SwitchMatrixModule::dataToJson ();
 
         json_object_set_new_bool (rootJ, "polyOnDemand", polyOnDemand);
 
@@ -49,35 +49,148 @@ namespace OuroborosModules::Modules::Branch {
     }
 
     void BranchModule::dataFromJson (json_t* rootJ) {
-        ModuleBase::dataFromJson (rootJ);
+        SwitchMatrixModule::dataFromJson (rootJ);
 
         json_object_try_get_bool (rootJ, "polyOnDemand", polyOnDemand);
     }
 
-    void BranchModule::process (const ProcessArgs& args) {
-        using Branchless::ConditionalSet;
+    uint64_t BranchModule::calculateRoutingKey () {
+        // Switch states take 2 bits each, output connections take 1 bit each. (0 channels means disconnected)
+        uint64_t key = 0;
+        for (int i = 0; i < SwitchCount; i++) {
+            auto switchState = std::clamp (static_cast<int> (params [PARAM_SWITCH + i].getValue ()), -1, 1) + 1;
+
+            key |= static_cast<uint64_t> (switchState) << (i * 2);
+            key |= static_cast<uint64_t> (outputs [OUTPUT_DESTINATION + i].isConnected ()) << (SwitchCount * 2 + i);
+        }
+
+        key |= static_cast<uint64_t> (inputs [INPUT_A].getChannels ()) << (SwitchCount * 3);
+        key |= static_cast<uint64_t> (inputs [INPUT_B].getChannels ()) << (SwitchCount * 3 + 5);
+        key |= static_cast<uint64_t> (polyOnDemand) << (SwitchCount * 3 + 10);
+
+        return key;
+    }
 
+    void BranchModule::updateRouting () {
         auto maxPolyphony = std::max (std::max (inputs [INPUT_A].getChannels (), inputs [INPUT_B].getChannels ()), 1);
 
-        float voltages [Constants::MaxPolyphony];
+        routeCount = 0;
         for (int destI = 0; destI < SwitchCount; destI++) {
-            auto& curDest = outputs [OUTPUT_DESTINATION + destI];
             auto curSwitchState = std::clamp (static_cast<int> (params [PARAM_SWITCH + destI].getValue ()), -1, 1);
+            fader.setTarget (destI, curSwitchState < 0);
+            fader.setTarget (SwitchCount + destI, curSwitchState > 0);
+
+            auto& curDest = outputs [OUTPUT_DESTINATION + destI];
+            if (!curDest.isConnected ())
+                continue;
+
+            auto sourceInputId = curSwitchState == -1 ? INPUT_A : INPUT_B;
+            auto realChannelCount = curSwitchState != 0 ? inputs [sourceInputId].getChannels () : 0;
+
+            // Channels past the source's channel count only need to be cleared when the routing changes.
+            curDest.setChannels (!polyOnDemand ? maxPolyphony : realChannelCount);
+            std::fill (curDest.getVoltages (realChannelCount), curDest.getVoltages (Constants::MaxPolyphony), 0.f);
+
+            if (realChannelCount < 1)
+                continue;
+
+            auto& route = routes [routeCount++];
+            route.outputId = OUTPUT_DESTINATION + destI;
+            route.sourceId = sourceInputId;
+            route.channelCount = realChannelCount;
+        }
+
+        fader.start (crossfadeSwitching);
+    }
+
+    void BranchModule::addMatrixRoutes (SwitchMatrix::MatrixData& matrix) {
+        // Unpatched sources are normalled to the chain's buses.
+        auto getSourceChannels = [&] (int bus) {
+            const auto& curInput = inputs [INPUT_A + bus];
+            return curInput.isConnected () ? curInput.getChannels () : matrix.busChannels [bus];
+        };
+        auto maxPolyphony = std::max (std::max (getSourceChannels (0), getSourceChannels (1)), 1);
+
+        for (int destI = 0; destI < SwitchCount; destI++) {
+            auto& curDest = outputs [OUTPUT_DESTINATION + destI];
             if (!curDest.isConnected ())
                 continue;
 
-            auto realChannelCount = 0;
-            if (curSwitchState != 0) {
-                auto sourceInputId = curSwitchState == -1 ? INPUT_A : INPUT_B;
-                inputs [sourceInputId].readVoltages (voltages);
-                realChannelCount = inputs [sourceInputId].getChannels ();
+            auto curSwitchState = std::clamp (static_cast<int> (params [PARAM_SWITCH + destI].getValue ()), -1, 1);
+            if (curSwitchState == 0) {
+                matrix.addRoute (&curDest, nullptr, 0, !polyOnDemand ? maxPolyphony : 0);
+                continue;
             }
 
-            for (int i = realChannelCount; i < Constants::MaxPolyphony; i++)
-                voltages [i] = 0;
+            auto bus = curSwitchState < 0 ? 0 : 1;
+            auto& curSource = inputs [INPUT_A + bus];
+            auto channelCount = getSourceChannels (bus);
+            auto source = curSource.isConnected () ? curSource.getVoltages () : matrix.busVoltages [bus];
 
-            curDest.setChannels (!polyOnDemand ? maxPolyphony : realChannelCount);
-            curDest.writeVoltages (voltages);
+            matrix.addRoute (&curDest, source, channelCount, !polyOnDemand ? maxPolyphony : channelCount);
+        }
+    }
+
+    void BranchModule::process (const ProcessArgs& args) {
+        if (processChain ())
+            return;
+
+        auto newRoutingKey = calculateRoutingKey ();
+        if (newRoutingKey != routingKey) {
+            routingKey = newRoutingKey;
+            updateRouting ();
         }
+
+        if (fader.active) {
+            processFade (args);
+            return;
+        }
+
+        // Copy straight from the sources' buffers, and only the live channels.
+        for (int routeI = 0; routeI < routeCount; routeI++) {
+            const auto& route = routes [routeI];
+            std::copy_n (inputs [route.sourceId].getVoltages (), route.channelCount, outputs [route.outputId].getVoltages ());
+        }
+    }
+
+    void BranchModule::processFade (const ProcessArgs& args) {
+        using rack::simd::float_4;
+
+        fader.step (args.sampleTime / SwitchMatrix::CrossfadeTime);
+
+        auto maxPolyphony = std::max (std::max (inputs [INPUT_A].getChannels (), inputs [INPUT_B].getChannels ()), 1);
+        for (int destI = 0; destI < SwitchCount; destI++) {
+            auto& curDest = outputs [OUTPUT_DESTINATION + destI];
+            if (!curDest.isConnected ())
+                continue;
+
+            // Sources that are fading out keep their channels alive until they're silent.
+            int polyphonyCount = polyOnDemand ? 0 : maxPolyphony;
+            float_4 voltages [SwitchMatrix::SIMDBankCount] = {};
+            for (int sourceI = 0; sourceI < 2; sourceI++) {
+                const auto& curSource = inputs [INPUT_A + sourceI];
+                auto gain = fader.getGain (sourceI * SwitchCount + destI);
+                auto channelCount = curSource.getChannels ();
+                if (gain <= 0.f || channelCount < 1)
+                    continue;
+
+                polyphonyCount = std::max (polyphonyCount, channelCount);
+                auto bankCount = (channelCount + SwitchMatrix::SIMDBankSize - 1) / SwitchMatrix::SIMDBankSize;
+                for (int bankI = 0; bankI < bankCount; bankI++) {
+                    auto curChannel = bankI * SwitchMatrix::SIMDBankSize;
+                    auto curBank = curSource.getVoltageSimd<float_4> (curChannel) * gain;
+                    voltages [bankI] += curBank & ((float_4 (0, 1, 2, 3) + curChannel) < channelCount);
+                }
+            }
+
+            curDest.setChannels (polyphonyCount);
+            auto bankCount = (polyphonyCount + SwitchMatrix::SIMDBankSize - 1) / SwitchMatrix::SIMDBankSize;
+            for (int bankI = 0; bankI < bankCount; bankI++)
+                curDest.setVoltageSimd (voltages [bankI], bankI * SwitchMatrix::SIMDBankSize);
+        }
+
+        // Once settled, go back to the regular routing.
+        if (!fader.active)
+            routingKey = ~0ull;
     }
 }
\ No newline at end of file
@@ -20,13 +20,20 @@
 
 #include "../ModuleBase.hpp"
 #include "../PluginDef.hpp"
+#include "../SwitchMatrix/SwitchMatrix.hpp"
 #include "../UI/CommonWidgets.hpp"
 #include "../UI/WidgetBase.hpp"
 
 namespace OuroborosModules::Modules::Branch {
-    struct BranchModule : ModuleBase {
+    struct BranchModule : SwitchMatrix::SwitchMatrixModule {
         static constexpr int SwitchCount = 8;
 
+        struct RouteData {
+            uint8_t outputId;
+            uint8_t sourceId;
+            uint8_t channelCount;
+        };
+
         enum ParamIds {
             ENUMS (PARAM_SWITCH, SwitchCount),
 
@@ -49,12 +56,24 @@ namespace OuroborosModules::Modules::Branch {
 
         bool polyOnDemand = false;
 
+        RouteData routes [SwitchCount];
+        int routeCount = 0;
+
         BranchModule ();
 
         json_t* dataToJson () override;
         void dataFromJson (json_t* rootJ) override;
 
         void process (const ProcessArgs& args) override;
+
+      protected:
+        uint64_t calculateRoutingKey () override;
+        void addMatrixInputs (SwitchMatrix::MatrixData& matrix) override { }
+        void addMatrixRoutes (SwitchMatrix::MatrixData& matrix) override;
+
+      private:
+        void updateRouting ();
+        void processFade (const ProcessArgs& args);
     };
 
     struct BranchWidget : Widgets::ModuleWidgetBase<BranchModule> {
@@ -73,5 +73,14 @@ namespace OuroborosModules::Modules::Branch {
             "Determine polyphony from selected source", "", "Toggle Branch \"Determine polyphony from selected source\"",
             &BranchModule::polyOnDemand
         ));
+        menu->addChild (createBoolPtrMenuItemWithHistory (
+            "Chain with adjacent Junctions and Branches", "", "Toggle Branch \"Chain with adjacent Junctions and Branches\"",
+            &BranchModule::chainEnabled
+        ));
+        menu->addChild (createBoolPtrMenuItemWithHistory (
+            "Crossfade when switching", "",
+            "Toggle Branch \"Crossfade when switching\"",
+            &BranchModule::crossfadeSwitching
+        ));
     }
 }
\ No newline at end of file
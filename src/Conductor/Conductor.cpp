@@ -316,6 +316,8 @@ namespace OuroborosModules::Modules::Conductor {
             lights [LIGHT_RESET_BUTTON].setBrightnessSmooth (boolToLight (resetLightPulse.isHigh ()), lightTime);
             lights [LIGHT_RESET_PATTERN_BUTTON].setBrightnessSmooth (boolToLight (resetPatternOn), lightTime);
             lights [LIGHT_MANUAL_SET_BUTTON].setBrightnessSmooth (boolToLight (manualSetLightPulse.isHigh ()), lightTime);
+
+            displayTelemetry.publish ({ currentPattern });
         }
     }
 }
\ No newline at end of file
@@ -22,6 +22,7 @@
 
 #include "../DSP/ClockDivider.hpp"
 #include "../PluginDef.hpp"
+#include "../Telemetry.hpp"
 #include "../UI/CommonWidgets.hpp"
 #include "../UI/WidgetBase.hpp"
 
@@ -131,6 +132,12 @@ namespace OuroborosModules::Modules::Conductor {
         // Clock dividers
         DSP::ClockDivider clockLights;
 
+        // Widget communication
+        struct DisplayData {
+            int currentPattern = 0;
+        };
+        TelemetryChannel<DisplayData> displayTelemetry;
+
         ConductorModule ();
 
         json_t* dataToJson () override;
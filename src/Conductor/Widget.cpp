@@ -74,7 +74,11 @@ namespace OuroborosModules::Modules::Conductor {
         // Display
         auto displayBox = findNamedBox ("widget_Display", rack::math::Rect ());
         auto displayWidget = createWidget<LedNumberDisplay> (displayBox.pos, displayBox.size, 32.f, 3, [&] {
-            return moduleT != nullptr ? moduleT->currentPattern + 1 : 16;
+            if (moduleT == nullptr)
+                return 16;
+
+            moduleT->displayTelemetry.update ();
+            return moduleT->displayTelemetry.read ().currentPattern + 1;
         });
         addChild (displayWidget);
     }
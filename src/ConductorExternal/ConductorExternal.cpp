@@ -374,6 +374,8 @@ namespace OuroborosModules::Modules::Conductor {
 
             for (int idx = LIGHT_MAP_BUTTON; idx < LIGHT_MAP_BUTTON_LAST + 1; idx++)
                 lights [idx].setBrightnessSmooth (boolToLight (mapButtonLightState [idx - LIGHT_MAP_BUTTON]), lightTime);
+
+            displayTelemetry.publish ({ enabled, selectedPattern, queuedPattern });
         }
     }
 }
\ No newline at end of file
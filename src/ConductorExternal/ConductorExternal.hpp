@@ -22,6 +22,7 @@
 
 #include "../DSP/ClockDivider.hpp"
 #include "../PluginDef.hpp"
+#include "../Telemetry.hpp"
 #include "../UI/CommonWidgets.hpp"
 #include "../UI/WidgetBase.hpp"
 
@@ -117,6 +118,14 @@ namespace OuroborosModules::Modules::Conductor {
         // Clock dividers
         DSP::ClockDivider clockLights;
 
+        // Widget communication
+        struct DisplayData {
+            bool enabled = false;
+            int selectedPattern = 0;
+            int queuedPattern = -1;
+        };
+        TelemetryChannel<DisplayData> displayTelemetry;
+
         ConductorExternalModule ();
 
         json_t* dataToJson () override;
@@ -64,13 +64,13 @@ namespace OuroborosModules::Modules::Conductor {
         // Displays
         auto selDisplayBox = findNamedBox ("widget_SelDisplay", rack::math::Rect ());
         selectionDisplay = createWidget<LedNumberDisplay> (selDisplayBox.pos, selDisplayBox.size, 32.f, 3, [&] {
-            return moduleT != nullptr ? moduleT->selectedPattern + 1 : 5;
+            return moduleT != nullptr ? moduleT->displayTelemetry.read ().selectedPattern + 1 : 5;
         });
         addChild (selectionDisplay);
 
         auto queueDisplayBox = findNamedBox ("widget_QueueDisplay", rack::math::Rect ());
         queueDisplay = createWidget<LedNumberDisplay> (queueDisplayBox.pos, queueDisplayBox.size, 32.f, 3, [&] {
-            return moduleT != nullptr ? moduleT->queuedPattern + 1 : 0;
+            return moduleT != nullptr ? moduleT->displayTelemetry.read ().queuedPattern + 1 : 0;
         });
         queueDisplay->disabled = moduleT == nullptr;
         addChild (queueDisplay);
@@ -82,10 +82,13 @@ namespace OuroborosModules::Modules::Conductor {
         if (moduleT == nullptr)
             return;
 
+        moduleT->displayTelemetry.update ();
+        const auto& displayData = moduleT->displayTelemetry.read ();
+
         if (selectionDisplay != nullptr)
-            selectionDisplay->disabled = !moduleT->enabled;
+            selectionDisplay->disabled = !displayData.enabled;
         if (queueDisplay != nullptr)
-            queueDisplay->disabled = !moduleT->enabled || moduleT->queuedPattern < 0;
+            queueDisplay->disabled = !displayData.enabled || displayData.queuedPattern < 0;
     }
 
     void ConductorExternalWidget::onChangeEmblem (EmblemId emblemId) {
@@ -122,6 +122,8 @@ namespace OuroborosModules::Modules::Conductor {
                 lights [LIGHT_PAD_BUTTON + i * 2].setBrightnessSmooth (boolToLight (redLightState), lightTime);
                 lights [LIGHT_PAD_BUTTON + i * 2 + 1].setBrightnessSmooth (boolToLight (blueLightState), lightTime);
             }
+
+            displayTelemetry.publish ({ enabled, curPage, queuedPattern });
         }
     }
 }
\ No newline at end of file
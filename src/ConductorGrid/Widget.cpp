@@ -119,7 +119,7 @@ namespace OuroborosModules::Modules::Conductor {
         // Page display and buttons.
         auto pageDisplayBox = findNamedBox ("widget_PageDisplay", rack::math::Rect ());
         pageDisplay = createWidget<LedNumberDisplay> (pageDisplayBox.pos, pageDisplayBox.size, 32.f, 3, [&] {
-            return moduleT != nullptr ? moduleT->curPage + 1 : 5;
+            return moduleT != nullptr ? moduleT->displayTelemetry.read ().curPage + 1 : 5;
         });
         addChild (pageDisplay);
 
@@ -129,7 +129,7 @@ namespace OuroborosModules::Modules::Conductor {
         // Queue display.
         auto queueDisplayBox = findNamedBox ("widget_QueueDisplay", rack::math::Rect ());
         queueDisplay = createWidget<LedNumberDisplay> (queueDisplayBox.pos, queueDisplayBox.size, 32.f, 3, [&] {
-            return moduleT != nullptr ? moduleT->queuedPattern + 1 : 0;
+            return moduleT != nullptr ? moduleT->displayTelemetry.read ().queuedPattern + 1 : 0;
         });
         queueDisplay->disabled = moduleT == nullptr;
         addChild (queueDisplay);
@@ -141,8 +141,11 @@ namespace OuroborosModules::Modules::Conductor {
         if (moduleT == nullptr)
             return;
 
-        pageDisplay->disabled = !moduleT->enabled;
-        queueDisplay->disabled = !moduleT->enabled || moduleT->queuedPattern < 0;
+        moduleT->displayTelemetry.update ();
+        const auto& displayData = moduleT->displayTelemetry.read ();
+
+        pageDisplay->disabled = !displayData.enabled;
+        queueDisplay->disabled = !displayData.enabled || displayData.queuedPattern < 0;
     }
 
     void ConductorGridWidget::onChangeEmblem (EmblemId emblemId) {
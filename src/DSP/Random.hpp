@@ -0,0 +1,82 @@
+/*
+ *  OuroborosModules
+ *  Copyright (C) 2025 Chronos "phantombeta" Ouroboros
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include "../PluginDef.hpp"
+#include "../Utils.hpp"
+
+namespace OuroborosModules::DSP {
+    inline uint64_t splitMix64 (uint64_t& x) {
+        auto z = (x += 0x9E3779B97F4A7C15ull);
+        z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ull;
+        z = (z ^ (z >> 27)) * 0x94D049BB133111EBull;
+        return z ^ (z >> 31);
+    }
+
+    /**
+     * xoshiro128+ running several independent streams side by side.
+     * The lanes are kept as separate arrays so the compiler can vectorize every step.
+     */
+    template<int LaneCount>
+    struct Xoshiro128PlusBatch {
+        static constexpr int Lanes = LaneCount;
+
+      private:
+        uint32_t state [4] [LaneCount];
+
+      public:
+        Xoshiro128PlusBatch () { seed (0); }
+        Xoshiro128PlusBatch (uint64_t seedValue) { seed (seedValue); }
+
+        void seed (uint64_t seedValue) {
+            // Expand the seed with SplitMix64, so every lane starts from a distinct, well mixed state.
+            for (int laneI = 0; laneI < LaneCount; laneI++) {
+                for (int i = 0; i < 4; i += 2) {
+                    auto mixed = splitMix64 (seedValue);
+                    state [i    ] [laneI] = static_cast<uint32_t> (mixed);
+                    state [i + 1] [laneI] = static_cast<uint32_t> (mixed >> 32);
+                }
+            }
+        }
+
+        void next (uint32_t* output) {
+            for (int laneI = 0; laneI < LaneCount; laneI++) {
+                output [laneI] = state [0] [laneI] + state [3] [laneI];
+
+                auto t = state [1] [laneI] << 9;
+                state [2] [laneI] ^= state [0] [laneI];
+                state [3] [laneI] ^= state [1] [laneI];
+                state [1] [laneI] ^= state [2] [laneI];
+                state [0] [laneI] ^= state [3] [laneI];
+                state [2] [laneI] ^= t;
+                state [3] [laneI] = Hashing::rotl (state [3] [laneI], 11);
+            }
+        }
+
+        /** Generates one uniform float in [0, 1) per lane. */
+        void nextUniform (float* output) {
+            uint32_t bits [LaneCount];
+            next (bits);
+
+            // The low bits of xoshiro128+ are weak, so only the top 24 are used.
+            for (int laneI = 0; laneI < LaneCount; laneI++)
+                output [laneI] = static_cast<float> (bits [laneI] >> 8) * 0x1.0p-24f;
+        }
+    };
+}
\ No newline at end of file
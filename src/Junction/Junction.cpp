@@ -39,14 +39,12 @@ namespace OuroborosModules::Modules::Junction {
         configOutput (OUTPUT_SIGNAL    , "A");
         configOutput (OUTPUT_SIGNAL + 1, "B");
 
-        clockUpdate = DSP::ClockDivider (32, rack::random::u32 ());
-
         for (int i = 0; i < OutputCount; i++)
             outputData [i] = OutputData ();
     }
 
     json_t* JunctionModule::dataToJson () {
-        auto rootJ = ModuleBase::dataToJson ();
+        auto rootJ = SwitchMatrixModule::dataToJson ();
 
         json_object_set_new_bool (rootJ, "polyOnDemand", polyOnDemand);
         json_object_set_new_bool (rootJ, "clampWhileSumming", clampWhileSumming);
@@ -55,78 +53,196 @@ namespace OuroborosModules::Modules::Junction {
     }
 
     void JunctionModule::dataFromJson (json_t* rootJ) {
-        ModuleBase::dataFromJson (rootJ);
+        SwitchMatrixModule::dataFromJson (rootJ);
 
         json_object_try_get_bool (rootJ, "polyOnDemand", polyOnDemand);
         json_object_try_get_bool (rootJ, "clampWhileSumming", clampWhileSumming);
     }
 
+    uint64_t JunctionModule::calculateRoutingKey () {
+        // Switch states take 2 bits each, channel counts take 5 bits each. (0 channels means disconnected)
+        uint64_t key = 0;
+        for (int i = 0; i < SwitchCount; i++) {
+            auto switchState = std::clamp (static_cast<int> (params [PARAM_SWITCH + i].getValue ()), -1, 1) + 1;
+            auto channelCount = inputs [INPUT_SIGNAL + i].getChannels ();
+
+            key |= static_cast<uint64_t> (switchState) << (i * 2);
+            key |= static_cast<uint64_t> (channelCount) << (SwitchCount * 2 + i * 5);
+        }
+
+        for (int i = 0; i < OutputCount; i++)
+            key |= static_cast<uint64_t> (outputs [OUTPUT_SIGNAL + i].isConnected ()) << (SwitchCount * 7 + i);
+        key |= static_cast<uint64_t> (polyOnDemand) << (SwitchCount * 7 + OutputCount);
+
+        return key;
+    }
+
+    void JunctionModule::updateRouting () {
+        int inputMaxPolyphony = 1;
+
+        for (int i = 0; i < OutputCount; i++)
+            outputData [i].resetInputs ();
+
+        for (uint8_t signalI = 0; signalI < SwitchCount; signalI++) {
+            auto curSwitchState = std::clamp (static_cast<int> (params [PARAM_SWITCH + signalI].getValue ()), -1, 1);
+            fader.setTarget (signalI, curSwitchState < 0);
+            fader.setTarget (SwitchCount + signalI, curSwitchState > 0);
+
+            auto channelCount = inputs [INPUT_SIGNAL + signalI].getChannels ();
+            if (channelCount < 1)
+                continue;
+
+            inputMaxPolyphony = std::max (inputMaxPolyphony, channelCount);
+            if (curSwitchState != 0)
+                outputData [(curSwitchState < 0) ? 0 : 1].addInput (signalI, channelCount);
+        }
+
+        for (int outputI = 0; outputI < OutputCount; outputI++) {
+            auto& curOutput = outputData [outputI];
+
+            int polyphonyCount = inputMaxPolyphony;
+            if (polyOnDemand) {
+                polyphonyCount = 1;
+                for (int inputI = 0; inputI < curOutput.inputCount; inputI++)
+                    polyphonyCount = std::max (polyphonyCount, static_cast<int> (curOutput.inputs [inputI].channelCount));
+            }
+
+            curOutput.active = outputs [OUTPUT_SIGNAL + outputI].isConnected ();
+            curOutput.bankCount = (polyphonyCount + SIMDBankSize - 1) / SIMDBankSize;
+            outputs [OUTPUT_SIGNAL + outputI].setChannels (polyphonyCount);
+        }
+
+        fader.start (crossfadeSwitching);
+    }
+
+    void JunctionModule::addMatrixInputs (SwitchMatrix::MatrixData& matrix) {
+        // The first Junction in the chain decides how the buses are summed.
+        if (!matrix.hasSettings) {
+            matrix.hasSettings = true;
+            matrix.polyOnDemand = polyOnDemand;
+            matrix.clampWhileSumming = clampWhileSumming;
+        }
+
+        for (int signalI = 0; signalI < SwitchCount; signalI++) {
+            auto curSwitchState = std::clamp (static_cast<int> (params [PARAM_SWITCH + signalI].getValue ()), -1, 1);
+            matrix.addInput (&inputs [INPUT_SIGNAL + signalI], curSwitchState == 0 ? -1 : (curSwitchState < 0 ? 0 : 1));
+        }
+    }
+
+    void JunctionModule::addMatrixRoutes (SwitchMatrix::MatrixData& matrix) {
+        for (int outputI = 0; outputI < OutputCount; outputI++) {
+            auto& curOutput = outputs [OUTPUT_SIGNAL + outputI];
+            if (!curOutput.isConnected ())
+                continue;
+
+            auto channelCount = matrix.busChannels [outputI];
+            matrix.addRoute (&curOutput, matrix.busVoltages [outputI], channelCount, channelCount);
+        }
+    }
+
     void JunctionModule::process (const ProcessArgs& args) {
         using rack::simd::float_4;
-        using Branchless::ConditionalSet;
 
-        std::array<OutputData, OutputCount> outputData = this->outputData;
-        if (clockUpdate.process ()) {
-            int inputMaxPolyphony = 1;
+        if (processChain ())
+            return;
 
-            for (int i = 0; i < OutputCount; i++)
-                outputData [i].resetInputs ();
+        auto newRoutingKey = calculateRoutingKey ();
+        if (newRoutingKey != routingKey) {
+            routingKey = newRoutingKey;
+            updateRouting ();
+        }
 
-            for (uint8_t signalI = 0; signalI < SwitchCount; signalI++) {
-                if (!inputs [INPUT_SIGNAL + signalI].isConnected ())
-                    continue;
+        if (fader.active) {
+            processFade (args);
+            return;
+        }
 
-                auto curSwitchState = std::clamp (static_cast<int> (params [PARAM_SWITCH + signalI].getValue ()), -1, 1);
-                inputMaxPolyphony = std::max (inputMaxPolyphony, inputs [INPUT_SIGNAL + signalI].getChannels ());
-                if (curSwitchState != 0)
-                    outputData [(curSwitchState < 0) ? 0 : 1].addInput (signalI);
-            }
+        auto voltageMax = float_4 (10);
+        auto voltageMin = -voltageMax;
+
+        for (int outputI = 0; outputI < OutputCount; outputI++) {
+            const auto& curOutput = outputData [outputI];
+            if (!curOutput.active)
+                continue;
 
-            if (!polyOnDemand) {
-                for (int i = 0; i < OutputCount; i++)
-                    outputs [OUTPUT_SIGNAL + i].setChannels (inputMaxPolyphony);
-            } else {
-                for (int outputI = 0; outputI < OutputCount; outputI++) {
-                    auto& curOutput = outputData [outputI];
+            float_4 voltages [SIMDBankCount] = {};
+            for (int inputI = 0; inputI < curOutput.inputCount; inputI++) {
+                const auto& curRoute = curOutput.inputs [inputI];
+                const auto& curInput = inputs [INPUT_SIGNAL + curRoute.inputId];
 
-                    int polyphonyCount = 1;
-                    for (int inputI = 0; inputI < curOutput.inputCount; inputI++)
-                        polyphonyCount = std::max (polyphonyCount, inputs [INPUT_SIGNAL + curOutput.inputs [inputI]].getChannels ());
+                auto bankCount = std::min (curRoute.bankCount, curOutput.bankCount);
+                for (int bankI = 0; bankI < bankCount; bankI++) {
+                    auto curChannel = bankI * SIMDBankSize;
+                    auto curBank = curInput.getVoltageSimd<float_4> (curChannel);
+                    curBank &= (float_4 (0, 1, 2, 3) + curChannel) < curRoute.channelCount;
 
-                    outputs [OUTPUT_SIGNAL + outputI].setChannels (polyphonyCount);
+                    voltages [bankI] += curBank;
+                    if (clampWhileSumming)
+                        voltages [bankI] = rack::simd::clamp (voltages [bankI], voltageMin, voltageMax);
                 }
             }
+
+            for (int bankI = 0; bankI < curOutput.bankCount; bankI++) {
+                if (!clampWhileSumming)
+                    voltages [bankI] = rack::simd::clamp (voltages [bankI], voltageMin, voltageMax);
+
+                outputs [OUTPUT_SIGNAL + outputI].setVoltageSimd (voltages [bankI], bankI * SIMDBankSize);
+            }
         }
+    }
+
+    void JunctionModule::processFade (const ProcessArgs& args) {
+        using rack::simd::float_4;
+
+        fader.step (args.sampleTime / SwitchMatrix::CrossfadeTime);
 
         auto voltageMax = float_4 (10);
         auto voltageMin = -voltageMax;
 
-        for (int outputI = 0; outputI < OutputCount; outputI++) {
-            auto& curOutput = outputData [outputI];
-            float_4 voltages [SIMDBankCount] = {};
+        int inputMaxPolyphony = 1;
+        for (int signalI = 0; signalI < SwitchCount; signalI++)
+            inputMaxPolyphony = std::max (inputMaxPolyphony, inputs [INPUT_SIGNAL + signalI].getChannels ());
 
-            for (int inputI = 0; inputI < curOutput.inputCount; inputI++) {
-                auto inputIdx = curOutput.inputs [inputI];
+        for (int outputI = 0; outputI < OutputCount; outputI++) {
+            auto& curOutput = outputs [OUTPUT_SIGNAL + outputI];
+            if (!curOutput.isConnected ())
+                continue;
 
-                if (!inputs [inputIdx].isConnected ())
+            // Inputs that are fading out keep their channels alive until they're silent.
+            int polyphonyCount = polyOnDemand ? 1 : inputMaxPolyphony;
+            float_4 voltages [SIMDBankCount] = {};
+            for (int signalI = 0; signalI < SwitchCount; signalI++) {
+                const auto& curInput = inputs [INPUT_SIGNAL + signalI];
+                auto gain = fader.getGain (outputI * SwitchCount + signalI);
+                auto channelCount = curInput.getChannels ();
+                if (gain <= 0.f || channelCount < 1)
                     continue;
 
-                auto inputChannelCount = inputs [inputIdx].getChannels ();
-                auto doClamp = clampWhileSumming ? true : (inputI == curOutput.inputCount - 1);
-                for (int bankI = 0; bankI < SIMDBankCount; bankI++) {
+                polyphonyCount = std::max (polyphonyCount, channelCount);
+                auto bankCount = (channelCount + SIMDBankSize - 1) / SIMDBankSize;
+                for (int bankI = 0; bankI < bankCount; bankI++) {
                     auto curChannel = bankI * SIMDBankSize;
-                    auto curBank = inputs [inputIdx].getVoltageSimd<float_4> (curChannel);
-                    curBank &= (float_4 (0, 1, 2, 3) + curChannel) < inputChannelCount;
+                    auto curBank = curInput.getVoltageSimd<float_4> (curChannel) * gain;
+                    curBank &= (float_4 (0, 1, 2, 3) + curChannel) < channelCount;
 
                     voltages [bankI] += curBank;
-                    ConditionalSet (voltages [bankI], doClamp, rack::simd::clamp (voltages [bankI], voltageMin, voltageMax));
+                    if (clampWhileSumming)
+                        voltages [bankI] = rack::simd::clamp (voltages [bankI], voltageMin, voltageMax);
                 }
             }
 
-            for (int i = 0; i < SIMDBankCount; i++)
-                outputs [OUTPUT_SIGNAL + outputI].setVoltageSimd (voltages [i], i * SIMDBankSize);
+            curOutput.setChannels (polyphonyCount);
+            auto bankCount = (polyphonyCount + SIMDBankSize - 1) / SIMDBankSize;
+            for (int bankI = 0; bankI < bankCount; bankI++) {
+                if (!clampWhileSumming)
+                    voltages [bankI] = rack::simd::clamp (voltages [bankI], voltageMin, voltageMax);
+
+                curOutput.setVoltageSimd (voltages [bankI], bankI * SIMDBankSize);
+            }
         }
 
-        this->outputData = outputData;
+        // Once settled, go back to the regular routing.
+        if (!fader.active)
+            routingKey = ~0ull;
     }
 }
\ No newline at end of file
@@ -18,28 +18,39 @@
 
 #pragma once
 
-#include "../DSP/ClockDivider.hpp"
 #include "../ModuleBase.hpp"
 #include "../PluginDef.hpp"
+#include "../SwitchMatrix/SwitchMatrix.hpp"
 #include "../UI/CommonWidgets.hpp"
 #include "../UI/WidgetBase.hpp"
 
 #include <array>
 
 namespace OuroborosModules::Modules::Junction {
-    struct JunctionModule : ModuleBase {
+    struct JunctionModule : SwitchMatrix::SwitchMatrixModule {
         static constexpr uint8_t SwitchCount = 8;
         static constexpr uint8_t OutputCount = 2;
 
         static constexpr int SIMDBankSize = 4;
         static constexpr int SIMDBankCount = static_cast<int> (static_cast<float> (Constants::MaxPolyphony) / SIMDBankSize + .5f);
 
+        struct RouteData {
+            uint8_t inputId;
+            uint8_t bankCount;
+            uint8_t channelCount;
+        };
+
         struct OutputData {
-            uint8_t inputs [SwitchCount];
+            RouteData inputs [SwitchCount];
             uint8_t inputCount = 0;
 
+            bool active = false;
+            uint8_t bankCount = 0;
+
             void resetInputs () { inputCount = 0; }
-            void addInput (uint8_t id) { inputs [inputCount++] = id; }
+            void addInput (uint8_t id, int channels) {
+                inputs [inputCount++] = { id, static_cast<uint8_t> ((channels + SIMDBankSize - 1) / SIMDBankSize), static_cast<uint8_t> (channels) };
+            }
         };
 
         enum ParamIds {
@@ -65,7 +76,6 @@ namespace OuroborosModules::Modules::Junction {
         bool clampWhileSumming = false;
 
         std::array<OutputData, OutputCount> outputData;
-        DSP::ClockDivider clockUpdate;
 
         JunctionModule ();
 
@@ -73,6 +83,15 @@ namespace OuroborosModules::Modules::Junction {
         void dataFromJson (json_t* rootJ) override;
 
         void process (const ProcessArgs& args) override;
+
+      protected:
+        uint64_t calculateRoutingKey () override;
+        void addMatrixInputs (SwitchMatrix::MatrixData& matrix) override;
+        void addMatrixRoutes (SwitchMatrix::MatrixData& matrix) override;
+
+      private:
+        void updateRouting ();
+        void processFade (const ProcessArgs& args);
     };
 
     struct JunctionWidget : Widgets::ModuleWidgetBase<JunctionModule> {
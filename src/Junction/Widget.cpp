@@ -79,5 +79,15 @@ namespace OuroborosModules::Modules::Junction {
             "Toggle Junction \"Clamp while summing\"",
             &JunctionModule::clampWhileSumming
         ));
+        menu->addChild (createBoolPtrMenuItemWithHistory (
+            "Chain with adjacent Junctions and Branches", "",
+            "Toggle Junction \"Chain with adjacent Junctions and Branches\"",
+            &JunctionModule::chainEnabled
+        ));
+        menu->addChild (createBoolPtrMenuItemWithHistory (
+            "Crossfade when switching", "",
+            "Toggle Junction \"Crossfade when switching\"",
+            &JunctionModule::crossfadeSwitching
+        ));
     }
 }
\ No newline at end of file
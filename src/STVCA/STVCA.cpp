@@ -44,6 +44,10 @@ namespace OuroborosModules::Modules::STVCA {
         // Configure bypasses.
         configBypass (INPUT_LEFT, OUTPUT_LEFT);
         configBypass (INPUT_RIGHT, OUTPUT_RIGHT);
+
+        clockDisplay = DSP::ClockDivider (DisplayDivision, rack::random::u32 ());
+        clockMeter = DSP::ClockDivider (MeterDivision);
+        updateSampleRate (1.f / 48000.f);
     }
 
     json_t* STVCAModule::dataToJson () {
@@ -51,6 +55,8 @@ namespace OuroborosModules::Modules::STVCA {
 
         json_object_set_new_bool (rootJ, "displayColor::UseDefault", displayColorUseDefault);
         json_object_set_new_struct (rootJ, "displayColor", displayColor);
+        json_object_set_new_enum (rootJ, "smoothing", smoothing);
+        json_object_set_new_bool (rootJ, "showMeters", showMeters);
 
         return rootJ;
     }
@@ -60,46 +66,123 @@ namespace OuroborosModules::Modules::STVCA {
 
         json_object_try_get_bool (rootJ, "displayColor::UseDefault", displayColorUseDefault);
         json_object_try_get_struct (rootJ, "displayColor", displayColor);
+        json_object_try_get_enum (rootJ, "smoothing", smoothing);
+        json_object_try_get_bool (rootJ, "showMeters", showMeters);
     }
 
     void STVCAModule::process (const ProcessArgs& args) {
+        using rack::simd::float_4;
+
+        auto& inputLeft = inputs [INPUT_LEFT];
+        auto& inputRight = inputs [INPUT_RIGHT];
+        auto& inputCV = inputs [INPUT_CV];
+        auto& outputLeft = outputs [OUTPUT_LEFT];
+        auto& outputRight = outputs [OUTPUT_RIGHT];
+
         auto channels = std::max ({
             1,
-            inputs [INPUT_LEFT].getChannels (),
-            inputs [INPUT_RIGHT].getChannels (),
-            inputs [INPUT_CV].getChannels (),
+            inputLeft.getChannels (),
+            inputRight.getChannels (),
+            inputCV.getChannels (),
         });
-        auto level = params [PARAM_LEVEL].getValue ();
 
-        for (int c = 0; c < channels; c++) {
+        auto level = float_4 (params [PARAM_LEVEL].getValue ());
+        auto cvConnected = inputCV.isConnected ();
+        auto exponential = static_cast<int> (params [PARAM_EXP].getValue ()) == 0;
+
+        auto smoothingMode = smoothing;
+        auto rampDelta = float_4 (smoothingRampDelta);
+        auto onePoleCoeff = float_4 (smoothingOnePoleCoeff);
+
+        // The display only needs the gains at a fraction of the sample rate.
+        auto publishDisplay = clockDisplay.process ();
+        auto& displayData = displayTelemetry.getWriteBuffer ();
+        auto meterClocked = showMeters && clockMeter.process ();
+        meterSampleCount += meterClocked;
+
+        outputLeft.setChannels (channels);
+        outputRight.setChannels (channels);
+
+        for (int c = 0; c < channels; c += 4) {
             // Calculate gain.
             auto gain = level;
-            if (inputs [INPUT_CV].isConnected ()) {
-                float cv = std::clamp (inputs [INPUT_CV].getPolyVoltage (c) / 10.f, 0.f, 1.f);
+            if (cvConnected) {
+                auto cv = rack::simd::clamp (inputCV.getPolyVoltageSimd<float_4> (c) * .1f, float_4 (0.f), float_4 (1.f));
 
-                if (int (params [PARAM_EXP].getValue ()) == 0)
-                    cv = std::pow (cv, 4.f);
+                if (exponential) {
+                    cv *= cv;
+                    cv *= cv;
+                }
 
                 gain *= cv;
             }
 
-            // Get inputs.
-            auto inL = inputs [INPUT_LEFT].getPolyVoltage (c);
-            auto inR = inputs [INPUT_RIGHT].getPolyVoltage (c);
+            // Smooth gain. Banks that already reached their target are left as a plain multiply.
+            // Channels that weren't in use last sample start at their target instead of a stale gain.
+            auto& smoothedGain = smoothedGains [c / SIMDBankSize];
+            if (c + SIMDBankSize > smoothedChannels)
+                smoothedGain = rack::simd::ifelse ((float_4 (0, 1, 2, 3) + c) < smoothedChannels, smoothedGain, gain);
+            if (smoothingMode != STVCASmoothing::Off && rack::simd::movemask (smoothedGain != gain) != 0) {
+                auto difference = gain - smoothedGain;
+
+                if (smoothingMode == STVCASmoothing::Linear)
+                    gain = smoothedGain + rack::simd::clamp (difference, -rampDelta, rampDelta);
+                else {
+                    auto newGain = smoothedGain + difference * onePoleCoeff;
+                    gain = rack::simd::ifelse (rack::simd::abs (gain - newGain) < 1e-5f, gain, newGain);
+                }
+            }
+            smoothedGain = gain;
+
+            // Apply gain and set outputs.
+            auto outLeft = inputLeft.getPolyVoltageSimd<float_4> (c) * gain;
+            auto outRight = inputRight.getPolyVoltageSimd<float_4> (c) * gain;
+            outputLeft.setVoltageSimd (outLeft, c);
+            outputRight.setVoltageSimd (outRight, c);
+
+            if (meterClocked) {
+                auto bankI = c / SIMDBankSize;
+                meterPeaks [0] [bankI] = rack::simd::fmax (meterPeaks [0] [bankI], rack::simd::abs (outLeft));
+                meterPeaks [1] [bankI] = rack::simd::fmax (meterPeaks [1] [bankI], rack::simd::abs (outRight));
+                meterSquares [0] [bankI] += outLeft * outLeft;
+                meterSquares [1] [bankI] += outRight * outRight;
+            }
 
-            // Apply gain.
-            inL *= gain;
-            inR *= gain;
-            lastGains [c] = gain;
+            if (publishDisplay)
+                gain.store (&displayData.gains [c]);
+        }
+        smoothedChannels = channels;
 
-            // Set outputs.
-            outputs [OUTPUT_LEFT].setVoltage (inL, c);
-            outputs [OUTPUT_RIGHT].setVoltage (inR, c);
+        if (publishDisplay) {
+            displayData.channels = channels;
+            publishMeters (displayData);
+            displayTelemetry.publish ();
         }
+    }
+
+    void STVCAModule::publishMeters (DisplayData& displayData) {
+        using rack::simd::float_4;
 
-        outputs [OUTPUT_LEFT].setChannels (channels);
-        outputs [OUTPUT_RIGHT].setChannels (channels);
-        lastChannels = channels;
+        displayData.showMeters = showMeters;
+        if (!showMeters)
+            return;
+
+        auto squaresScale = float_4 (1.f / std::max (meterSampleCount, 1));
+        auto peakDecay = float_4 (meterPeakDecay);
+        for (int sideI = 0; sideI < 2; sideI++) {
+            for (int bankI = 0; bankI < SIMDBankCount; bankI++) {
+                auto& peakHold = meterPeakHolds [sideI] [bankI];
+                peakHold = rack::simd::fmax (meterPeaks [sideI] [bankI], peakHold * peakDecay);
+
+                peakHold.store (&displayData.meterPeaks [sideI] [bankI * SIMDBankSize]);
+                rack::simd::sqrt (meterSquares [sideI] [bankI] * squaresScale).store (&displayData.meterRMS [sideI] [bankI * SIMDBankSize]);
+
+                meterPeaks [sideI] [bankI] = 0.f;
+                meterSquares [sideI] [bankI] = 0.f;
+            }
+        }
+
+        meterSampleCount = 0;
     }
 
     void STVCAModule::onReset (const ResetEvent& e) {
@@ -107,5 +190,19 @@ namespace OuroborosModules::Modules::STVCA {
 
         displayColorUseDefault = true;
         displayColor = RGBColor ();
+        smoothing = STVCASmoothing::Off;
+        showMeters = false;
+    }
+
+    void STVCAModule::onSampleRateChange (const SampleRateChangeEvent& e) {
+        ModuleBase::onSampleRateChange (e);
+
+        updateSampleRate (e.sampleTime);
+    }
+
+    void STVCAModule::updateSampleRate (float sampleTime) {
+        smoothingRampDelta = sampleTime / SmoothingRampTime;
+        smoothingOnePoleCoeff = 1.f - std::exp (-sampleTime / SmoothingOnePoleTime);
+        meterPeakDecay = std::exp (-sampleTime * DisplayDivision / MeterPeakDecayTime);
     }
 }
\ No newline at end of file
@@ -19,14 +19,35 @@
 
 #pragma once
 
+#include "../DSP/ClockDivider.hpp"
 #include "../ModuleBase.hpp"
 #include "../PluginDef.hpp"
+#include "../Telemetry.hpp"
 #include "../UI/CommonWidgets.hpp"
 #include "../UI/WidgetBase.hpp"
 #include "../Utils.hpp"
 
 namespace OuroborosModules::Modules::STVCA {
+    enum class STVCASmoothing : int {
+        Off,
+        Linear,
+        OnePole,
+    };
+
     struct STVCAModule : ModuleBase, SST_NeighborConnectable_V1 {
+        static constexpr int SIMDBankSize = 4;
+        static constexpr int SIMDBankCount = Constants::MaxPolyphony / SIMDBankSize;
+
+        /** How long a linear ramp takes to go across the whole gain range. */
+        static constexpr float SmoothingRampTime = 5e-3f;
+        static constexpr float SmoothingOnePoleTime = 1e-3f;
+
+        static constexpr int DisplayDivision = 256;
+        /** The meters only look at every Nth sample. */
+        static constexpr int MeterDivision = 4;
+        /** Time for the peak hold to fall by 1/e. */
+        static constexpr float MeterPeakDecayTime = .5f;
+
         enum ParamId {
             PARAM_LEVEL,
             PARAM_EXP,
@@ -53,8 +74,18 @@ namespace OuroborosModules::Modules::STVCA {
         bool displayColorUseDefault = true;
         RGBColor displayColor = RGBColor ();
 
-        int lastChannels = 1;
-        float lastGains [16] = { };
+        STVCASmoothing smoothing = STVCASmoothing::Off;
+        bool showMeters = false;
+
+        struct DisplayData {
+            int channels = 1;
+            float gains [Constants::MaxPolyphony] = { };
+
+            bool showMeters = false;
+            float meterPeaks [2] [Constants::MaxPolyphony] = { };
+            float meterRMS [2] [Constants::MaxPolyphony] = { };
+        };
+        TelemetryChannel<DisplayData> displayTelemetry;
 
         STVCAModule ();
 
@@ -63,6 +94,7 @@ namespace OuroborosModules::Modules::STVCA {
 
         void process (const ProcessArgs& args) override;
         void onReset (const ResetEvent& e) override;
+        void onSampleRateChange (const SampleRateChangeEvent& e) override;
 
         std::optional<std::vector<labeledStereoPort_t>> getPrimaryInputs () override {
             return {{ std::make_pair ("Input", std::make_pair (INPUT_LEFT, INPUT_RIGHT)) }};
@@ -71,6 +103,25 @@ namespace OuroborosModules::Modules::STVCA {
         std::optional<std::vector<labeledStereoPort_t>> getPrimaryOutputs () override {
             return {{ std::make_pair ("Output", std::make_pair (OUTPUT_LEFT, OUTPUT_RIGHT)) }};
         }
+
+      private:
+        DSP::ClockDivider clockDisplay;
+        DSP::ClockDivider clockMeter;
+
+        rack::simd::float_4 meterPeaks [2] [SIMDBankCount] = {};
+        rack::simd::float_4 meterPeakHolds [2] [SIMDBankCount] = {};
+        rack::simd::float_4 meterSquares [2] [SIMDBankCount] = {};
+        int meterSampleCount = 0;
+        float meterPeakDecay = 0.f;
+
+        rack::simd::float_4 smoothedGains [SIMDBankCount] = {};
+        /** The channel count the smoothed gains were last updated for. */
+        int smoothedChannels = 0;
+        float smoothingRampDelta = 0.f;
+        float smoothingOnePoleCoeff = 0.f;
+
+        void updateSampleRate (float sampleTime);
+        void publishMeters (DisplayData& displayData);
     };
 
     struct STVCAWidget : Widgets::ModuleWidgetBase<STVCAModule> {
@@ -84,6 +135,7 @@ namespace OuroborosModules::Modules::STVCA {
         void initializeWidget () override;
 
         void onChangeEmblem (EmblemId emblemId) override;
+        void appendContextMenu (rack::ui::Menu* menu) override;
         void createLocalStyleMenu (rack::ui::Menu* menu) override;
         void createPluginSettingsMenu (rack::ui::Menu* menu) override;
     };
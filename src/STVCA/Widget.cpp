@@ -28,6 +28,63 @@ namespace OuroborosModules::Modules::STVCA {
     STVCAWidget::STVCAWidget (STVCAModule* module) { constructor (module, "panels/ST-VCA"); }
 
     struct STVCASlider : rack::app::SliderKnob {
+        /** The bottom of the meters, relative to 10V at the top. */
+        static constexpr float MeterRangeDB = 48.f;
+
+        static float levelToHeight (float voltage) {
+            auto decibels = 20.f * std::log10 (std::max (voltage, 1e-6f) / 10.f);
+            return std::clamp (decibels / MeterRangeDB + 1.f, 0.f, 1.f);
+        }
+
+        void drawMeters (const DrawArgs& args, const STVCAModule::DisplayData& displayData) {
+            auto r = box.zeroPos ();
+            auto channels = displayData.channels;
+            auto sideWidth = r.size.x / channels / 2;
+
+            // Each channel's segment is split into left and right.
+            nvgBeginPath (args.vg);
+            auto rmsFill = false;
+            for (auto c = 0; c < channels; c++) {
+                for (auto sideI = 0; sideI < 2; sideI++) {
+                    auto height = levelToHeight (displayData.meterRMS [sideI] [c]);
+                    if (height <= 0.f)
+                        continue;
+
+                    rmsFill = true;
+                    nvgRect (args.vg,
+                        r.pos.x + sideWidth * (c * 2 + sideI),
+                        r.pos.y + r.size.y * (1 - height),
+                        sideWidth,
+                        r.size.y * height
+                    );
+                }
+            }
+            nvgFillColor (args.vg, rack::color::mult (rack::color::WHITE, .4f));
+            if (rmsFill)
+                nvgFill (args.vg);
+
+            nvgBeginPath (args.vg);
+            auto peakFill = false;
+            for (auto c = 0; c < channels; c++) {
+                for (auto sideI = 0; sideI < 2; sideI++) {
+                    auto height = levelToHeight (displayData.meterPeaks [sideI] [c]);
+                    if (height <= 0.f)
+                        continue;
+
+                    peakFill = true;
+                    nvgRect (args.vg,
+                        r.pos.x + sideWidth * (c * 2 + sideI),
+                        r.pos.y + r.size.y * (1 - height),
+                        sideWidth,
+                        1.5f
+                    );
+                }
+            }
+            nvgFillColor (args.vg, rack::color::mult (rack::color::WHITE, .8f));
+            if (peakFill)
+                nvgFill (args.vg);
+        }
+
         void drawLayer (const DrawArgs& args, int layer) override {
             if (layer != 1)
                 return;
@@ -36,7 +93,13 @@ namespace OuroborosModules::Modules::STVCA {
 
             auto r = box.zeroPos ();
 
-            auto channels = module ? module->lastChannels : 1;
+            const STVCAModule::DisplayData* displayData = nullptr;
+            if (module != nullptr) {
+                module->displayTelemetry.update ();
+                displayData = &module->displayTelemetry.read ();
+            }
+
+            auto channels = displayData ? displayData->channels : 1;
             auto pq = getParamQuantity ();
             auto value = pq ? pq->getValue () : 1.f;
 
@@ -57,7 +120,7 @@ namespace OuroborosModules::Modules::STVCA {
             nvgBeginPath (args.vg);
             auto segmentFill = false;
             for (auto c = 0; c < channels; c++) {
-                auto gain = module ? module->lastGains [c] : 1.f;
+                auto gain = displayData ? displayData->gains [c] : 1.f;
 
                 if (gain >= .005f) {
                     segmentFill = true;
@@ -78,6 +141,10 @@ namespace OuroborosModules::Modules::STVCA {
             if (segmentFill)
                 nvgFill (args.vg);
 
+            // Output meters.
+            if (displayData != nullptr && displayData->showMeters)
+                drawMeters (args, *displayData);
+
             // Invisible separators.
             const int segs = 25;
             nvgBeginPath (args.vg);
@@ -143,6 +210,35 @@ namespace OuroborosModules::Modules::STVCA {
         emblemWidget->setEmblem (emblemId);
     }
 
+    void STVCAWidget::appendContextMenu (rack::ui::Menu* menu) {
+        using rack::ui::Menu;
+
+        _WidgetBase::appendContextMenu (menu);
+
+        menu->addChild (new rack::ui::MenuSeparator);
+        menu->addChild (rack::createSubmenuItem ("Gain smoothing", "", [=] (Menu* menu) {
+            auto createFunc = [=] (std::string name, STVCASmoothing mode) {
+                menu->addChild (rack::createCheckMenuItem (name, "",
+                    [=] { return moduleT->smoothing == mode; },
+                    [=] {
+                        createContextMenuHistory<STVCASmoothing> ("Set ST-VCA gain smoothing", [=] (STVCAModule* module, STVCASmoothing value) {
+                            module->smoothing = value;
+                        }, moduleT->smoothing, mode);
+                    }
+                ));
+            };
+
+            createFunc ("Off", STVCASmoothing::Off);
+            createFunc ("Linear ramp", STVCASmoothing::Linear);
+            createFunc ("One-pole", STVCASmoothing::OnePole);
+        }));
+        menu->addChild (createBoolPtrMenuItemWithHistory (
+            "Show output meters", "",
+            "Toggle ST-VCA \"Show output meters\"",
+            &STVCAModule::showMeters
+        ));
+    }
+
     struct HistoryChangeDisplayColor : rack::history::ModuleAction {
       private:
         struct ColorValue {
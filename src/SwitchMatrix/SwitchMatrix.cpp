@@ -0,0 +1,246 @@
+/*
+ *  OuroborosModules
+ *  Copyright (C) 2024-2025 Chronos "phantombeta" Ouroboros
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "SwitchMatrix.hpp"
+
+#include "../JsonUtils.hpp"
+
+namespace OuroborosModules::Modules::SwitchMatrix {
+    /*
+     * RouteFader
+     */
+    void RouteFader::start (bool fade) {
+        fade &= primed;
+        primed = true;
+
+        active = false;
+        for (int bankI = 0; bankI < BankCount; bankI++) {
+            if (!fade)
+                gains [bankI] = targets [bankI];
+
+            active |= rack::simd::movemask (gains [bankI] != targets [bankI]) != 0;
+        }
+    }
+
+    void RouteFader::step (float delta) {
+        using rack::simd::float_4;
+
+        auto deltaMax = float_4 (delta);
+        auto deltaMin = -deltaMax;
+
+        active = false;
+        for (int bankI = 0; bankI < BankCount; bankI++) {
+            gains [bankI] += rack::simd::clamp (targets [bankI] - gains [bankI], deltaMin, deltaMax);
+            active |= rack::simd::movemask (gains [bankI] != targets [bankI]) != 0;
+        }
+    }
+
+    /*
+     * MatrixData
+     */
+    void MatrixData::reset () {
+        inputCount = 0;
+        inputMaxPolyphony = 1;
+        for (int i = 0; i < BusCount; i++)
+            busMasks [i] = 0;
+
+        routeCount = 0;
+        hasSettings = false;
+    }
+
+    void MatrixData::addInput (rack::engine::Input* input, int bus) {
+        auto channelCount = input->getChannels ();
+        if (channelCount < 1)
+            return;
+
+        inputMaxPolyphony = std::max (inputMaxPolyphony, channelCount);
+        if (bus < 0 || inputCount >= MaxChainPorts)
+            return;
+
+        busMasks [bus] |= 1ull << inputCount;
+        inputs [inputCount++] = {
+            input,
+            static_cast<uint8_t> (channelCount),
+            static_cast<uint8_t> ((channelCount + SIMDBankSize - 1) / SIMDBankSize)
+        };
+    }
+
+    void MatrixData::addRoute (rack::engine::Output* output, const float* source, int channelCount, int outputChannels) {
+        // Channels past the source's channel count only need to be cleared when the routing changes.
+        output->setChannels (outputChannels);
+        std::fill (output->getVoltages (channelCount), output->getVoltages (Constants::MaxPolyphony), 0.f);
+
+        if (channelCount < 1 || routeCount >= MaxChainPorts)
+            return;
+
+        routes [routeCount++] = { source, output, static_cast<uint8_t> (channelCount) };
+    }
+
+    void MatrixData::updateBuses () {
+        for (int busI = 0; busI < BusCount; busI++) {
+            if (!polyOnDemand) {
+                busChannels [busI] = inputMaxPolyphony;
+                continue;
+            }
+
+            busChannels [busI] = 1;
+            for (auto mask = busMasks [busI]; mask != 0; mask &= mask - 1)
+                busChannels [busI] = std::max (busChannels [busI], static_cast<int> (inputs [__builtin_ctzll (mask)].channelCount));
+        }
+    }
+
+    /*
+     * SwitchMatrixModule
+     */
+    json_t* SwitchMatrixModule::dataToJson () {
+        auto rootJ = ModuleBase::dataToJson ();
+
+        json_object_set_new_bool (rootJ, "chainEnabled", chainEnabled);
+        json_object_set_new_bool (rootJ, "crossfadeSwitching", crossfadeSwitching);
+
+        return rootJ;
+    }
+
+    void SwitchMatrixModule::dataFromJson (json_t* rootJ) {
+        ModuleBase::dataFromJson (rootJ);
+
+        json_object_try_get_bool (rootJ, "chainEnabled", chainEnabled);
+        json_object_try_get_bool (rootJ, "crossfadeSwitching", crossfadeSwitching);
+    }
+
+    SwitchMatrixModule* SwitchMatrixModule::asChainNode (rack::engine::Module* module) {
+        // Comparing the models is much cheaper than a dynamic_cast, and this runs every sample.
+        if (module == nullptr || (module->model != modelJunction && module->model != modelBranch))
+            return nullptr;
+
+        auto node = static_cast<SwitchMatrixModule*> (module);
+        return node->chainEnabled ? node : nullptr;
+    }
+
+    int SwitchMatrixModule::getChainPosition () {
+        int position = 0;
+        for (auto module = getLeftExpander ().module; position < MaxChainLength; module = module->getLeftExpander ().module) {
+            if (asChainNode (module) == nullptr)
+                break;
+
+            position++;
+        }
+
+        return position;
+    }
+
+    bool SwitchMatrixModule::processChain () {
+        if (!chainEnabled) {
+            matrix.nodeCount = 0;
+            return false;
+        }
+
+        // Modules past the maximum chain length work by themselves.
+        auto position = getChainPosition ();
+        if (position >= MaxChainLength)
+            return false;
+
+        // Driven by the chain's core. The standalone routing has to be rebuilt once the chain is broken up.
+        if (position > 0) {
+            routingKey = ~0ull;
+            fader.unprime ();
+            return true;
+        }
+
+        std::array<SwitchMatrixModule*, MaxChainLength> chain;
+        int chainLength = 0;
+        chain [chainLength++] = this;
+        for (auto module = getRightExpander ().module; chainLength < MaxChainLength; module = module->getRightExpander ().module) {
+            auto node = asChainNode (module);
+            if (node == nullptr)
+                break;
+
+            chain [chainLength++] = node;
+        }
+
+        if (chainLength < 2) {
+            matrix.nodeCount = 0;
+            return false;
+        }
+
+        routingKey = ~0ull;
+        fader.unprime ();
+
+        auto routingChanged = chainLength != matrix.nodeCount;
+        for (int nodeI = 0; nodeI < chainLength; nodeI++) {
+            MatrixData::NodeData nodeData = { chain [nodeI]->id, chain [nodeI]->calculateRoutingKey () };
+
+            auto& curNode = matrix.nodes [nodeI];
+            routingChanged |= curNode.moduleId != nodeData.moduleId || curNode.routingKey != nodeData.routingKey;
+            curNode = nodeData;
+        }
+        matrix.nodeCount = chainLength;
+
+        if (routingChanged) {
+            matrix.reset ();
+            for (int nodeI = 0; nodeI < chainLength; nodeI++)
+                chain [nodeI]->addMatrixInputs (matrix);
+            matrix.updateBuses ();
+            for (int nodeI = 0; nodeI < chainLength; nodeI++)
+                chain [nodeI]->addMatrixRoutes (matrix);
+        }
+
+        processMatrix ();
+        return true;
+    }
+
+    void SwitchMatrixModule::processMatrix () {
+        using rack::simd::float_4;
+
+        auto voltageMax = float_4 (10);
+        auto voltageMin = -voltageMax;
+
+        // Sum every bus in one pass over the chain's inputs.
+        for (int busI = 0; busI < BusCount; busI++) {
+            auto busBankCount = (matrix.busChannels [busI] + SIMDBankSize - 1) / SIMDBankSize;
+
+            float_4 voltages [SIMDBankCount] = {};
+            for (auto mask = matrix.busMasks [busI]; mask != 0; mask &= mask - 1) {
+                const auto& curInput = matrix.inputs [__builtin_ctzll (mask)];
+
+                auto bankCount = std::min (static_cast<int> (curInput.bankCount), busBankCount);
+                for (int bankI = 0; bankI < bankCount; bankI++) {
+                    auto curChannel = bankI * SIMDBankSize;
+                    auto curBank = curInput.input->getVoltageSimd<float_4> (curChannel);
+                    curBank &= (float_4 (0, 1, 2, 3) + curChannel) < curInput.channelCount;
+
+                    voltages [bankI] += curBank;
+                    if (matrix.clampWhileSumming)
+                        voltages [bankI] = rack::simd::clamp (voltages [bankI], voltageMin, voltageMax);
+                }
+            }
+
+            for (int bankI = 0; bankI < busBankCount; bankI++) {
+                if (!matrix.clampWhileSumming)
+                    voltages [bankI] = rack::simd::clamp (voltages [bankI], voltageMin, voltageMax);
+
+                voltages [bankI].store (&matrix.busVoltages [busI] [bankI * SIMDBankSize]);
+            }
+        }
+
+        for (int routeI = 0; routeI < matrix.routeCount; routeI++) {
+            const auto& route = matrix.routes [routeI];
+            std::copy_n (route.source, route.channelCount, route.output->getVoltages ());
+        }
+    }
+}
\ No newline at end of file
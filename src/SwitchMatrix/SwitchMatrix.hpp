@@ -0,0 +1,131 @@
+/*
+ *  OuroborosModules
+ *  Copyright (C) 2024-2025 Chronos "phantombeta" Ouroboros
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include "../ModuleBase.hpp"
+#include "../PluginDef.hpp"
+
+#include <array>
+
+namespace OuroborosModules::Modules::SwitchMatrix {
+    static constexpr int MaxChainLength = 8;
+    static constexpr int MaxChainPorts = 64;
+    static constexpr int BusCount = 2;
+
+    static constexpr int SIMDBankSize = 4;
+    static constexpr int SIMDBankCount = Constants::MaxPolyphony / SIMDBankSize;
+
+    static constexpr float CrossfadeTime = 5e-3f;
+
+    /** Linear gain ramps for every route of a module. Only stepped while a switch transition is active. */
+    struct RouteFader {
+        static constexpr int RouteCount = 16;
+        static constexpr int BankCount = RouteCount / SIMDBankSize;
+
+        rack::simd::float_4 gains [BankCount] = {};
+        rack::simd::float_4 targets [BankCount] = {};
+        bool active = false;
+        /** Whether the gains follow this module's own routing. Until then, there's nothing to fade from. */
+        bool primed = false;
+
+        float getGain (int route) const { return gains [route / SIMDBankSize] [route % SIMDBankSize]; }
+        void setTarget (int route, bool enabled) { targets [route / SIMDBankSize] [route % SIMDBankSize] = enabled ? 1.f : 0.f; }
+
+        /** Starts ramping towards the targets, or jumps straight to them if fading is disabled or the fader isn't primed. */
+        void start (bool fade);
+        void step (float delta);
+        /** Makes the next start jump to the targets. Used while the module's routing is driven by a chain. */
+        void unprime () {
+            primed = false;
+            active = false;
+        }
+    };
+
+    /** The routing of a whole chain of Junctions and Branches. Routes are kept as one input bitmask per bus. */
+    struct MatrixData {
+        struct NodeData {
+            int64_t moduleId;
+            uint64_t routingKey;
+        };
+
+        struct InputData {
+            rack::engine::Input* input;
+            uint8_t channelCount;
+            uint8_t bankCount;
+        };
+
+        struct RouteData {
+            const float* source;
+            rack::engine::Output* output;
+            uint8_t channelCount;
+        };
+
+        std::array<NodeData, MaxChainLength> nodes;
+        int nodeCount = 0;
+
+        std::array<InputData, MaxChainPorts> inputs;
+        int inputCount = 0;
+        int inputMaxPolyphony = 1;
+        uint64_t busMasks [BusCount] = { };
+
+        std::array<RouteData, MaxChainPorts> routes;
+        int routeCount = 0;
+
+        bool hasSettings = false;
+        bool polyOnDemand = false;
+        bool clampWhileSumming = false;
+
+        int busChannels [BusCount] = { };
+        alignas (16) float busVoltages [BusCount] [Constants::MaxPolyphony] = { };
+
+        void reset ();
+        void addInput (rack::engine::Input* input, int bus);
+        void addRoute (rack::engine::Output* output, const float* source, int channelCount, int outputChannels);
+        void updateBuses ();
+    };
+
+    struct SwitchMatrixModule : ModuleBase {
+        bool chainEnabled = false;
+        bool crossfadeSwitching = false;
+
+        json_t* dataToJson () override;
+        void dataFromJson (json_t* rootJ) override;
+
+      protected:
+        uint64_t routingKey = ~0ull;
+        RouteFader fader;
+
+        /** Packs everything the routing depends on. Only changes when a switch, connection or channel count changes. */
+        virtual uint64_t calculateRoutingKey () = 0;
+        /** Adds this module's inputs to the chain's buses. Called on the chain's core. */
+        virtual void addMatrixInputs (MatrixData& matrix) = 0;
+        /** Adds this module's outputs to the chain. Called on the chain's core, after every node's inputs were added. */
+        virtual void addMatrixRoutes (MatrixData& matrix) = 0;
+
+        /** Processes the whole chain if this module is its core. Returns false if the module should process by itself. */
+        bool processChain ();
+
+      private:
+        MatrixData matrix;
+
+        static SwitchMatrixModule* asChainNode (rack::engine::Module* module);
+        int getChainPosition ();
+        void processMatrix ();
+    };
+}
\ No newline at end of file
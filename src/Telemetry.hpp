@@ -0,0 +1,69 @@
+/*
+ *  OuroborosModules
+ *  Copyright (C) 2024-2025 Chronos "phantombeta" Ouroboros
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+
+namespace OuroborosModules {
+    /**
+     * Passes snapshots from the audio thread to the UI thread without locking.
+     * Triple buffered: the writer and the reader each own a buffer and swap it with the shared middle one,
+     * so the reader always sees a whole snapshot and neither side ever waits on the other.
+     * Only one thread may write and only one thread may read.
+     */
+    template<typename T>
+    struct TelemetryChannel {
+      private:
+        static constexpr uint8_t IndexMask = 0b011;
+        static constexpr uint8_t FlagNewData = 0b100;
+
+        T buffers [3] = { };
+        std::atomic<uint8_t> sharedIndex { 1 };
+        uint8_t writeIndex = 0;
+        uint8_t readIndex = 2;
+
+      public:
+        /** Audio thread. The buffer to write the next snapshot into. It holds stale data, so it must be fully written. */
+        T& getWriteBuffer () { return buffers [writeIndex]; }
+
+        /** Audio thread. Hands the written snapshot over to the reader. */
+        void publish () {
+            writeIndex = sharedIndex.exchange (writeIndex | FlagNewData, std::memory_order_acq_rel) & IndexMask;
+        }
+
+        /** Audio thread. Writes and publishes a whole snapshot. */
+        void publish (const T& value) {
+            getWriteBuffer () = value;
+            publish ();
+        }
+
+        /** UI thread. Picks up the latest snapshot. Returns true if there was a new one. */
+        bool update () {
+            if ((sharedIndex.load (std::memory_order_relaxed) & FlagNewData) == 0)
+                return false;
+
+            readIndex = sharedIndex.exchange (readIndex, std::memory_order_acq_rel) & IndexMask;
+            return true;
+        }
+
+        /** UI thread. The latest snapshot picked up by update (). */
+        const T& read () const { return buffers [readIndex]; }
+    };
+}
\ No newline at end of file